@@ -5,6 +5,11 @@
  * 	Calculates the oriented unit normal vector field for a disorder 3D point set.
  * 	Depends on the "Point Set Processing" package of CGAL.
  *
+ * 	Large point sets can be processed in tiles: the points are split into spatial blocks
+ * 	whose working set fits in a memory budget, the normals of each block are estimated
+ * 	and oriented with an overlap margin taken from the neighboring blocks, and the
+ * 	orientations of the blocks are reconciled across their seams.
+ *
  * 	by Dillon Cislo
  * 	02/18/2019
  *
@@ -17,14 +22,24 @@
 #include <vector>
 #include <utility>
 #include <list>
+#include <map>
+#include <algorithm>
+#include <limits>
+#include <cmath>
+#include <chrono>
 #include <stdexcept>
 #include <iostream>
 
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
+
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/pca_estimate_normals.h>
 #include <CGAL/jet_estimate_normals.h>
 #include <CGAL/vcm_estimate_normals.h>
 #include <CGAL/mst_orient_normals.h>
+#include <CGAL/compute_average_spacing.h>
 #include <CGAL/property_map.h>
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel 	Kernel;
@@ -58,9 +73,525 @@ enum NORMAL_ESTIMATION {
 
 };
 
+///
+/// A leaf of the spatial partition: a range of the permuted point indices and the box of
+/// its cell
+///
+struct Point_block {
+
+	std::size_t begin;
+	std::size_t end;
+	double lo[3];
+	double hi[3];
+
+};
+
+///
+/// A point in the margin of a block, with the normal found for it by that block. It is
+/// kept until the block owning the point has been processed
+///
+struct Seam_point {
+
+	int block;
+	std::size_t point;
+	Vector normal;
+
+};
+
+///
+/// Sum of the dot products of the normals two blocks found for their shared points,
+/// keyed by the pair of blocks in increasing order
+///
+typedef std::map< std::pair<int, int>, double > Seam_agreement;
+
+///
+/// Estimate the normals of a point range with the chosen procedure
+///
+template <typename PointRange, typename NamedParameters>
+void estimate_normals( PointRange &points, int estimation_procedure, int nn,
+		double offset_radius, double convolution_radius, const NamedParameters &np ) {
+
+	switch( estimation_procedure ) {
+
+		case JET_NORMALS :
+
+			/*
+            CGAL::jet_estimate_normals<Concurrency_tag>( points, nn, np );
+             */
+			break;
+
+		case PCA_NORMALS :
+
+			CGAL::pca_estimate_normals<Concurrency_tag>( points, nn, np );
+			break;
+
+		case VCM_NORMALS :
+
+			CGAL::vcm_estimate_normals( points,
+				  offset_radius, convolution_radius, np );
+
+			break;
+
+	}
+
+};
+
+///
+/// Split the points into blocks of at most maxPoints points by cutting the longest side
+/// of each cell at its median point. 'perm' receives the point indices ordered by block
+///
+void partition_points( const double *pts, std::size_t numPoints, std::size_t maxPoints,
+		std::vector<std::size_t> &perm, std::vector<Point_block> &blocks ) {
+
+	perm.resize( numPoints );
+	for( std::size_t i = 0; i < numPoints; i++ ) perm[i] = i;
+
+	Point_block root;
+	root.begin = 0;
+	root.end = numPoints;
+	for( int d = 0; d < 3; d++ ) {
+		root.lo[d] = std::numeric_limits<double>::infinity();
+		root.hi[d] = -std::numeric_limits<double>::infinity();
+	}
+
+	for( std::size_t i = 0; i < numPoints; i++ ) {
+		for( int d = 0; d < 3; d++ ) {
+			root.lo[d] = std::min( root.lo[d], pts[i+(d*numPoints)] );
+			root.hi[d] = std::max( root.hi[d], pts[i+(d*numPoints)] );
+		}
+	}
+
+	blocks.clear();
+	std::vector<Point_block> cells( 1, root );
+	while ( !cells.empty() ) {
+
+		Point_block cell = cells.back();
+		cells.pop_back();
+
+		if ( ( cell.end - cell.begin ) <= maxPoints ) {
+			blocks.push_back( cell );
+			continue;
+		}
+
+		int axis = 0;
+		for( int d = 1; d < 3; d++ ) {
+			if ( ( cell.hi[d] - cell.lo[d] ) > ( cell.hi[axis] - cell.lo[axis] ) ) axis = d;
+		}
+
+		const double *x = pts + (axis*numPoints);
+		std::size_t mid = cell.begin + ( cell.end - cell.begin ) / 2;
+		std::nth_element( perm.begin() + cell.begin, perm.begin() + mid,
+				perm.begin() + cell.end,
+				[x]( std::size_t a, std::size_t b ) { return x[a] < x[b]; } );
+
+		Point_block left = cell;
+		Point_block right = cell;
+		left.end = mid;
+		left.hi[axis] = x[perm[mid]];
+		right.begin = mid;
+		right.lo[axis] = x[perm[mid]];
+
+		// The left cell is split first, the blocks are listed in depth-first order
+		cells.push_back( right );
+		cells.push_back( left );
+
+	}
+
+};
+
+///
+/// Copy the points listed in 'index' out of the MATLAB point list. The CGAL neighbor
+/// searches need an lvalue point map, so each block holds its own points
+///
+void block_points( const double *pts, std::size_t numPoints,
+		const std::vector<std::size_t> &index, std::vector<Point> &points ) {
+
+	points.clear();
+	points.reserve( index.size() );
+	for( std::size_t k = 0; k < index.size(); k++ ) {
+		std::size_t i = index[k];
+		points.push_back( Point( pts[i], pts[i+numPoints], pts[i+(2*numPoints)] ) );
+	}
+
+};
+
+///
+/// Append to 'index' the points of the other blocks lying within 'margin' of the cell of
+/// block b
+///
+void block_margin( const double *pts, std::size_t numPoints,
+		const std::vector<std::size_t> &perm, const std::vector<Point_block> &blocks,
+		std::size_t b, double margin, std::vector<std::size_t> &index ) {
+
+	double lo[3], hi[3];
+	for( int d = 0; d < 3; d++ ) {
+		lo[d] = blocks[b].lo[d] - margin;
+		hi[d] = blocks[b].hi[d] + margin;
+	}
+
+	for( std::size_t c = 0; c < blocks.size(); c++ ) {
+
+		if ( c == b ) continue;
+
+		bool overlap = true;
+		for( int d = 0; d < 3; d++ ) {
+			if ( ( blocks[c].hi[d] < lo[d] ) || ( blocks[c].lo[d] > hi[d] ) ) overlap = false;
+		}
+		if ( !overlap ) continue;
+
+		for( std::size_t k = blocks[c].begin; k < blocks[c].end; k++ ) {
+
+			std::size_t i = perm[k];
+			bool inside = true;
+			for( int d = 0; d < 3; d++ ) {
+				double x = pts[i+(d*numPoints)];
+				if ( ( x < lo[d] ) || ( x > hi[d] ) ) inside = false;
+			}
+			if ( inside ) index.push_back( i );
+
+		}
+
+	}
+
+};
+
+///
+/// Add the dot product of the normal a block found for a point of its margin with the
+/// normal found by the block owning the point, once the owner has been processed
+///
+void seam_agreement( const Seam_point &seam, const std::vector<int> &owner,
+		const std::vector<char> &oriented, const double *normals, std::size_t numPoints,
+		Seam_agreement &agreement ) {
+
+	std::size_t i = seam.point;
+	if ( !oriented[i] ) return;
+
+	const Vector &n = seam.normal;
+	double dot = n.x() * normals[i] + n.y() * normals[i+numPoints] +
+		n.z() * normals[i+(2*numPoints)];
+
+	int a = std::min( seam.block, owner[i] );
+	int b = std::max( seam.block, owner[i] );
+	agreement[ std::make_pair( a, b ) ] += dot;
+
+};
+
+///
+/// Find the flip of each block that makes the normals agree across the block seams.
+///
+/// Two blocks agree when the dot products of the normals they found for their shared
+/// points sum to a positive value. The pairs of blocks are merged from the most to the
+/// least confident one with a union-find keeping the flip of each block relative to its
+/// parent, so the flips follow a maximum spanning forest of the seams. In each component
+/// the block holding the highest point keeps its orientation, as mst_orient_normals
+/// orients the normal of the highest point towards +Z
+///
+std::vector<char> reconcile_blocks( std::size_t numBlocks,
+		const Seam_agreement &agreement, const std::vector<double> &topZ ) {
+
+	std::vector< std::pair< double, std::pair<int, int> > > seamOrder;
+	for( Seam_agreement::const_iterator it = agreement.begin();
+			it != agreement.end(); it++ ) {
+		if ( it->second != 0.0 ) {
+			seamOrder.push_back( std::make_pair( -std::abs( it->second ), it->first ) );
+		}
+	}
+	std::sort( seamOrder.begin(), seamOrder.end() );
+
+	// Union-find with the flip of each block relative to its parent
+	std::vector<int> parent( numBlocks );
+	std::vector<char> flip( numBlocks, 0 );
+	for( std::size_t b = 0; b < numBlocks; b++ ) parent[b] = (int) b;
+
+	struct Find {
+		static int root( std::vector<int> &parent, std::vector<char> &flip, int b ) {
+			if ( parent[b] == b ) return b;
+			int r = root( parent, flip, parent[b] );
+			flip[b] ^= flip[ parent[b] ];
+			parent[b] = r;
+			return r;
+		};
+	};
+
+	for( std::size_t s = 0; s < seamOrder.size(); s++ ) {
+
+		int a = seamOrder[s].second.first;
+		int b = seamOrder[s].second.second;
+		char disagree = ( agreement.find( seamOrder[s].second )->second < 0.0 ) ? 1 : 0;
+
+		int ra = Find::root( parent, flip, a );
+		int rb = Find::root( parent, flip, b );
+		if ( ra == rb ) continue;
+
+		parent[rb] = ra;
+		flip[rb] = flip[a] ^ flip[b] ^ disagree;
+
+	}
+
+	// Flip of each block relative to the root of its component
+	std::vector<int> root( numBlocks );
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+		root[b] = Find::root( parent, flip, (int) b );
+	}
+
+	// The block with the highest point of each component keeps its orientation
+	std::vector<int> top( numBlocks, -1 );
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+		int r = root[b];
+		if ( ( top[r] < 0 ) || ( topZ[b] > topZ[ top[r] ] ) ) top[r] = (int) b;
+	}
+
+	// Read the flips of the top blocks before any of them is changed
+	std::vector<char> topFlip( numBlocks );
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+		topFlip[b] = flip[ top[ root[b] ] ];
+	}
+
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+		flip[b] ^= topFlip[b];
+	}
+
+	return flip;
+
+};
+
+///
+/// Peak resident set size of the process in megabytes, NaN if unknown
+///
+double peak_rss_mb() {
+
+#if defined(__APPLE__)
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return (double) usage.ru_maxrss / ( 1024.0 * 1024.0 );
+#elif !defined(_WIN32)
+	struct rusage usage;
+	getrusage( RUSAGE_SELF, &usage );
+	return (double) usage.ru_maxrss / 1024.0;
+#else
+	return mxGetNaN();
+#endif
+
+};
+
+///
+/// Tiled estimation and orientation of the normals. The normals of the oriented points
+/// are written to plhs[0] and the oriented points to plhs[1], in input order. Returns the
+/// number of oriented points
+///
+std::size_t tiled_point_set_normals( mxArray *plhs[], const double *pts,
+		std::size_t numPoints, int estimation_procedure, int nn, double offset_radius,
+		double convolution_radius, int orient_neighbors, std::size_t max_tile_points,
+		double &tile_margin, std::size_t &numBlocks ) {
+
+	int k = std::max( nn, orient_neighbors );
+
+	// -------------------------------------------------------------------------------------
+	// SPATIAL PARTITION
+	// -------------------------------------------------------------------------------------
+
+	std::vector<std::size_t> perm;
+	std::vector<Point_block> blocks;
+	partition_points( pts, numPoints, max_tile_points, perm, blocks );
+	numBlocks = blocks.size();
+
+	std::vector<int> owner( numPoints );
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+		for( std::size_t k = blocks[b].begin; k < blocks[b].end; k++ ) owner[ perm[k] ] = (int) b;
+	}
+
+	// Positions of the points of a block, the range handed to CGAL, and their coordinates
+	std::vector<std::size_t> local;
+	std::vector<Point> blockPoints;
+
+	if ( tile_margin < 0.0 ) {
+
+		// The k-neighborhoods span about sqrt(k/6) times the spacing of the 6-neighborhoods
+		std::vector<std::size_t> index( perm.begin() + blocks[0].begin,
+				perm.begin() + blocks[0].end );
+		local.resize( index.size() );
+		for( std::size_t i = 0; i < local.size(); i++ ) local[i] = i;
+		block_points( pts, numPoints, index, blockPoints );
+
+		double spacing = CGAL::compute_average_spacing<Concurrency_tag>( local, 6,
+				CGAL::parameters::point_map( CGAL::make_property_map( blockPoints ) ) );
+
+		tile_margin = 2.0 * spacing * std::sqrt( k / 6.0 );
+
+	}
+
+	if ( estimation_procedure == VCM_NORMALS ) {
+		tile_margin = std::max( tile_margin, offset_radius + convolution_radius );
+	}
+
+	// -------------------------------------------------------------------------------------
+	// ESTIMATE AND ORIENT NORMALS BLOCK BY BLOCK
+	// -------------------------------------------------------------------------------------
+
+	plhs[0] = mxCreateDoubleMatrix( numPoints, 3, mxREAL );
+	double *vn_out = mxGetPr( plhs[0] );
+
+	std::vector<char> oriented( numPoints, 0 );
+	std::vector<double> topZ( numBlocks, -std::numeric_limits<double>::infinity() );
+
+	std::vector<std::size_t> index;
+	std::vector<Vector> blockNormals;
+
+	// The margin normals are compared with those of their owner as soon as both exist,
+	// only the ones whose owner comes later are kept
+	Seam_agreement agreement;
+	std::vector< std::vector<Seam_point> > pending( numBlocks );
+
+	for( std::size_t b = 0; b < numBlocks; b++ ) {
+
+		// The points of the block come first, then the margin
+		index.assign( perm.begin() + blocks[b].begin, perm.begin() + blocks[b].end );
+		std::size_t numCore = index.size();
+
+		block_margin( pts, numPoints, perm, blocks, b, tile_margin, index );
+
+		local.resize( index.size() );
+		for( std::size_t i = 0; i < local.size(); i++ ) local[i] = i;
+		block_points( pts, numPoints, index, blockPoints );
+		blockNormals.assign( index.size(), Vector( 0, 0, 0 ) );
+
+		estimate_normals( local, estimation_procedure, nn,
+				offset_radius, convolution_radius,
+				CGAL::parameters::point_map( CGAL::make_property_map( blockPoints ) ).
+				normal_map( CGAL::make_property_map( blockNormals ) ) );
+
+		std::vector<std::size_t>::iterator unoriented_points_begin =
+			CGAL::mst_orient_normals( local, orient_neighbors,
+					CGAL::parameters::point_map( CGAL::make_property_map( blockPoints ) ).
+					normal_map( CGAL::make_property_map( blockNormals ) ) );
+
+		for( std::vector<std::size_t>::iterator it = local.begin();
+				it != unoriented_points_begin; it++ ) {
+
+			std::size_t i = index[*it];
+			const Vector &n = blockNormals[*it];
+
+			if ( *it < numCore ) {
+
+				oriented[i] = 1;
+				vn_out[i] = n.x();
+				vn_out[i+numPoints] = n.y();
+				vn_out[i+(2*numPoints)] = n.z();
+				topZ[b] = std::max( topZ[b], pts[i+(2*numPoints)] );
+
+			} else {
+
+				Seam_point seam = { (int) b, i, n };
+				if ( owner[i] < (int) b ) {
+					seam_agreement( seam, owner, oriented, vn_out, numPoints, agreement );
+				} else {
+					pending[ owner[i] ].push_back( seam );
+				}
+
+			}
+
+		}
+
+		// The normals the previous blocks found in their margins for the points of this one
+		for( std::size_t s = 0; s < pending[b].size(); s++ ) {
+			seam_agreement( pending[b][s], owner, oriented, vn_out, numPoints, agreement );
+		}
+		std::vector<Seam_point>().swap( pending[b] );
+
+	}
+
+	// -------------------------------------------------------------------------------------
+	// RECONCILE ORIENTATIONS ACROSS BLOCK SEAMS
+	// -------------------------------------------------------------------------------------
+
+	std::vector<char> flip = reconcile_blocks( numBlocks, agreement, topZ );
+
+	for( std::size_t i = 0; i < numPoints; i++ ) {
+		if ( oriented[i] && flip[ owner[i] ] ) {
+			for( int d = 0; d < 3; d++ ) vn_out[i+(d*numPoints)] = -vn_out[i+(d*numPoints)];
+		}
+	}
+
+	// -------------------------------------------------------------------------------------
+	// OUTPUT PROCESSING
+	// -------------------------------------------------------------------------------------
+
+	std::size_t numOriented = 0;
+	for( std::size_t i = 0; i < numPoints; i++ ) numOriented += oriented[i];
+
+	plhs[1] = mxCreateDoubleMatrix( numOriented, 3, mxREAL );
+	double *vv_out = mxGetPr( plhs[1] );
+
+	// Drop the unoriented points, compacting the normals in place
+	for( int d = 0; d < 3; d++ ) {
+		std::size_t j = 0;
+		for( std::size_t i = 0; i < numPoints; i++ ) {
+			if ( !oriented[i] ) continue;
+			vn_out[j+(d*numOriented)] = vn_out[i+(d*numPoints)];
+			vv_out[j+(d*numOriented)] = pts[i+(d*numPoints)];
+			j++;
+		}
+	}
+
+	mxSetM( plhs[0], numOriented );
+
+	return numOriented;
+
+};
+
+///
+/// Set the flag of unoriented points and the optional run statistics
+///
+void status_outputs( int nlhs, mxArray *plhs[], std::size_t numPoints,
+		std::size_t numOriented, std::size_t numBlocks, double tile_margin,
+		std::chrono::steady_clock::time_point start ) {
+
+	double elapsed = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start ).count();
+
+	plhs[2] = mxCreateLogicalMatrix(1,1);
+	bool *unoriented = mxGetLogicals( plhs[2] );
+
+	if ( numOriented != numPoints ) {
+		*unoriented = true;
+	} else {
+		*unoriented = false;
+	}
+
+	if ( nlhs == 4 ) {
+
+		const char *fieldNames[] = { "numBlocks", "tileMargin", "time",
+			"pointsPerSecond", "peakRSS" };
+		double values[] = { (double) numBlocks, tile_margin, elapsed,
+			numPoints / elapsed, peak_rss_mb() };
+
+		plhs[3] = mxCreateStructMatrix( 1, 1, 5, fieldNames );
+		for( int f = 0; f < 5; f++ ) {
+			mxSetFieldByNumber( plhs[3], 0, f, mxCreateDoubleScalar( values[f] ) );
+		}
+
+	}
+
+};
+
 ///
 /// Brief main function to call computational functionalities
 ///
+/// [ PN, P, unoriented, stats ] = point_set_normals( P, param, orient_neighbors )
+///
+/// Setting param.memory_budget (in megabytes) or param.max_tile_points turns on the tiled
+/// mode. The points are split into blocks whose estimated working set fits in what the
+/// budget leaves after the arrays kept for every point (61 bytes per point), each block
+/// is processed with the points of its neighbors lying within
+/// param.tile_margin of it. The margin defaults to twice the radius
+/// of the neighborhoods used by the estimation. The tiled mode returns the oriented
+/// points in input order.
+///
+/// The budget does not cover the margin normals kept until the block owning their points
+/// is processed, nor the input itself. The optional 'stats' output reports the number of
+/// blocks, the margin, the run time, the throughput in points per second and the peak
+/// resident set size in megabytes, which measures the actual peak.
+///
 void mexFunction( int nlhs, mxArray *plhs[],
 		int nrhs, const mxArray *prhs[] ) {
 
@@ -72,9 +603,9 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	if ( nrhs != 3 ) {
 		mexErrMsgIdAndTxt( "MATLAB:point_set_normals:nargin",
 				"POINT_SET_NORMALS requires three input arguments." );
-	} else if ( nlhs != 3 ) {
+	} else if ( ( nlhs != 3 ) && ( nlhs != 4 ) ) {
 		mexErrMsgIdAndTxt( "MATLAB:point_set_normals:nargout",
-				"POINT_SET_NORMALS requires three output arguments." );
+				"POINT_SET_NORMALS requires three or four output arguments." );
 	}
 
 	// The point coordinate list
@@ -141,6 +672,72 @@ void mexFunction( int nlhs, mxArray *plhs[],
 				"Number of neighbors used to orient normals must be positive.");
 	}
 
+	// Tiling processing -------------------------------------------------------------------
+
+	bool tiled = false;
+	double memory_budget = 0.0;
+	std::size_t max_tile_points = 0;
+	double tile_margin = -1.0;
+
+	if( (idx = mxGetFieldNumber( prhs[1], "memory_budget" )) != -1 ) {
+		tiled = true;
+		memory_budget = *mxGetPr(mxGetFieldByNumber( prhs[1], 0, idx ));
+		if ( memory_budget <= 0.0 ) {
+			mexErrMsgIdAndTxt( "MATLAB:point_set_normals:memory_budget",
+					"Memory budget must be positive." );
+		}
+	}
+
+	if( (idx = mxGetFieldNumber( prhs[1], "max_tile_points" )) != -1 ) {
+		tiled = true;
+		max_tile_points = (std::size_t) *mxGetPr(mxGetFieldByNumber( prhs[1], 0, idx ));
+	}
+
+	if( (idx = mxGetFieldNumber( prhs[1], "tile_margin" )) != -1 ) {
+		tile_margin = *mxGetPr(mxGetFieldByNumber( prhs[1], 0, idx ));
+	}
+
+	int k = std::max( nn, orient_neighbors );
+
+	if ( tiled && ( max_tile_points == 0 ) ) {
+
+		// Arrays kept for every point whatever the blocks: the two outputs, the block
+		// permutation, the owner block and the orientation flag
+		double fixed_budget = 61.0 * numPoints / ( 1024.0 * 1024.0 );
+		if ( memory_budget <= fixed_budget ) {
+			mexErrMsgIdAndTxt( "MATLAB:point_set_normals:memory_budget",
+					"Memory budget must exceed the %.1f MB taken by the per-point arrays.",
+					fixed_budget );
+		}
+
+		// Estimated working set of a block, per point: the point and normal copies, the
+		// search tree, and the k-nearest neighbor graph built by mst_orient_normals. Half
+		// of the rest of the budget is left to the margins
+		double bytes_per_point = 280.0 + 64.0 * k;
+		max_tile_points = (std::size_t) ( 0.5 * ( memory_budget - fixed_budget ) *
+				1024.0 * 1024.0 / bytes_per_point );
+
+	}
+
+	if ( tiled && ( max_tile_points <= (std::size_t) k ) ) {
+		mexErrMsgIdAndTxt( "MATLAB:point_set_normals:max_tile_points",
+				"Blocks must hold more points than the number of neighbors." );
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if ( tiled ) {
+
+		std::size_t numBlocks;
+		std::size_t numOriented = tiled_point_set_normals( plhs, pts, numPoints,
+				estimation_procedure, nn, offset_radius, convolution_radius,
+				orient_neighbors, max_tile_points, tile_margin, numBlocks );
+
+		status_outputs( nlhs, plhs, numPoints, numOriented, numBlocks, tile_margin, start );
+		return;
+
+	}
+
 	// Create Point-Vector Pair vector range -----------------------------------------------
 	
 	std::vector<PointVectorPair> points;
@@ -158,36 +755,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	// ESTIMATE NORMALS
 	// -------------------------------------------------------------------------------------
 	
-	switch( estimation_procedure ) {
-
-		case JET_NORMALS :
-
-			/*
-            CGAL::jet_estimate_normals<Concurrency_tag>
-				( points, nn,
-				  CGAL::parameters::point_map(Point_map()).
-				  normal_map(Vector_map()) );
-             */
-			break;
-
-		case PCA_NORMALS :
-
-			CGAL::pca_estimate_normals<Concurrency_tag>
-				( points, nn,
-				  CGAL::parameters::point_map(Point_map()).
-				  normal_map(Vector_map()) );
-			break;
-
-		case VCM_NORMALS :
-
-			CGAL::vcm_estimate_normals( points,
-				  offset_radius, convolution_radius,
-				  CGAL::parameters::point_map(Point_map()).
-				  normal_map(Vector_map()) );
-
-			break;
-
-	}
+	estimate_normals( points, estimation_procedure, nn,
+			offset_radius, convolution_radius,
+			CGAL::parameters::point_map(Point_map()).
+			normal_map(Vector_map()) );
 
 	// -------------------------------------------------------------------------------------
 	// ORIENT NORMAL VECTOR FIELD
@@ -223,14 +794,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
 
 	}
 
-	plhs[2] = mxCreateLogicalMatrix(1,1);
-	bool *unoriented = mxGetLogicals( plhs[2] );
-
-	if ( points.size() != numPoints ) {
-		*unoriented = true;
-	} else {
-		*unoriented = false;
-	}
+	status_outputs( nlhs, plhs, numPoints, points.size(), 1, 0.0, start );
 
 	return;
 
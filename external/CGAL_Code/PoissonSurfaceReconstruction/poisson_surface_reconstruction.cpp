@@ -21,15 +21,38 @@
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Polyhedron_3.h>
 #include <CGAL/poisson_surface_reconstruction.h>
+#include <CGAL/compute_average_spacing.h>
+#include <CGAL/property_map.h>
 #include <CGAL/IO/Polyhedron_iostream.h>
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel 	Kernel;
 typedef Kernel::Point_3 					Point;
 typedef Kernel::Vector_3 					Vector;
 
-typedef std::pair<Point, Vector> 				Pwn;
-typedef CGAL::First_of_pair_property_map<Pwn>		 	Point_map;
-typedef CGAL::Second_of_pair_property_map<Pwn>		 	Vector_map;
+///
+/// Readable property map from the index of a point to the row of a MATLAB N x 3 array,
+/// so that the normals are read in place instead of being copied into pairs
+///
+template <typename T>
+struct Column_map {
+
+	typedef std::size_t 				key_type;
+	typedef T 					value_type;
+	typedef T 					reference;
+	typedef boost::readable_property_map_tag 	category;
+
+	const double *data;
+	std::size_t n;
+
+	Column_map( const double *d, std::size_t numRows ) : data( d ), n( numRows ) {};
+
+	friend T get( const Column_map &map, std::size_t i ) {
+		return T( map.data[i], map.data[i+map.n], map.data[i+(2*map.n)] );
+	};
+
+};
+
+typedef Column_map<Vector> 					Vector_map;
 
 typedef CGAL::Polyhedron_3<Kernel> 				Polyhedron;
 
@@ -109,19 +132,19 @@ void mexFunction( int nlhs, mxArray *plhs[],
         "Could not convert file name to string." );
   }
 
-	// Load points and normal vectors into pair structure ----------------------------------
+	// Index the points. The neighbor search of compute_average_spacing needs an lvalue
+	// point map, so the coordinates are copied; the normals are read in place ------------
 	
-	std::vector<Pwn> points;
-	points.reserve( numPoints );
-	for( int i = 0; i < numPoints; i++ ) {
-
-		Point pp = Point( pts[i], pts[i+numPoints], pts[i+(2*numPoints)] );
-		Vector vp = Vector( pn[i], pn[i+numPoints], pn[i+(2*numPoints)] );
-
-		points.push_back( std::make_pair( pp, vp ) );
-
+	std::vector<std::size_t> points( numPoints );
+	std::vector<Point> coords;
+	coords.reserve( numPoints );
+	for( std::size_t i = 0; i < numPoints; i++ ) {
+		points[i] = i;
+		coords.push_back( Point( pts[i], pts[i+numPoints], pts[i+(2*numPoints)] ) );
 	}
 
+	Vector_map normal_map( pn, numPoints );
+
 	// -------------------------------------------------------------------------------------
 	// CONSTRUCT MESH TRIANGULATION
 	// -------------------------------------------------------------------------------------
@@ -129,10 +152,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	Polyhedron output_mesh;
 
 	double average_spacing = CGAL::compute_average_spacing<Concurrency_tag>
-		( points, 6, CGAL::parameters::point_map(Point_map()) );
+		( points, 6, CGAL::parameters::point_map( CGAL::make_property_map(coords) ) );
 
 	bool mesh_success = CGAL::poisson_surface_reconstruction_delaunay
-		( points.begin(), points.end(), Point_map(), Vector_map(),
+		( points.begin(), points.end(), CGAL::make_property_map(coords), normal_map,
 		  output_mesh, average_spacing );
 
 	if (!mesh_success) {
@@ -1,5 +1,5 @@
-function [geodesicPaths, pointLocations] = surfaceGeodesicPairs( face, ...
-    vertex, pointPairs, pointCoordinates )
+function [geodesicPaths, pointLocations, geodesicLengths] = ...
+    surfaceGeodesicPairs( face, vertex, pointPairs, pointCoordinates, options )
 %SURFACEGEODESICPAIRS This function calculates the surface geodesic paths
 %between pairs of points on a 3D mesh triangulation.  The points are
 %assumed to be elements of face interiors, i.e. not vertices or elements of
@@ -23,6 +23,10 @@ function [geodesicPaths, pointLocations] = surfaceGeodesicPairs( face, ...
 %   3d coordinates sampled by pointPairs for determining what physical
 %   point locations to connect via face-spanning geodesics. Could be the
 %   same as vertex. 
+% options : struct, optional
+%   lengthsOnly : if true, only the geodesic lengths are computed and
+%       geodesicPaths is an empty cell array (default false)
+%   numThreads : number of threads, 0 for the OpenMP default (default 0)
 % 
 % Returns 
 % -------
@@ -31,6 +35,8 @@ function [geodesicPaths, pointLocations] = surfaceGeodesicPairs( face, ...
 %   edge intersection, etc, until we terminate.% 
 % pointLocations : 
 %  
+% geodesicLengths : Q x 1 float array
+%   length of each geodesic, NaN if the points are not connected
 %
 % DJCislo
 
@@ -42,6 +48,7 @@ if(nargin<1), error('Please supply face connectivity list!'); end
 if(nargin<2), error('Please supply vertex coordinates!'); end
 if(nargin<3), error('Please supply source/target coordinates!' ); end
 if(nargin<4), error('Please supply source/target pair list!' ); end
+if(nargin<5), options = struct(); end
 
 % Check the size of the face connectivity list
 sizef = size(face);
@@ -81,11 +88,6 @@ elseif ( min(pointPairs(:)) < 1 )
     error('The source/target pair list contains a point smaller than 1');
 end
 
-% *************************************************************************
-% TODO: CREATE BOND LIST SORT TO MINIMIZE SEQUENCE TREE RECONSTRUCTIONS IN
-% NUMERICAL ALGORITHM
-% *************************************************************************
-
 % Update vertex and point IDs to match the 0-indexing in C++
 face = face-1; pointPairs = pointPairs-1;
 
@@ -93,10 +95,13 @@ face = face-1; pointPairs = pointPairs-1;
 % Calculate Geodesic Paths!
 %--------------------------------------------------------------------------
 
+% Bonds are grouped by source inside the MEX file, the outputs follow the
+% input order
 [ geodesicPaths, ...
     pointFaceLocations, ...
-    pointBarycentricCoordinates ] = surface_geodesic_pairs( uint64(face), ...
-    vertex, uint64(pointPairs), pointCoordinates );
+    pointBarycentricCoordinates, ...
+    geodesicLengths ] = surface_geodesic_pairs( uint64(face), ...
+    vertex, uint64(pointPairs), pointCoordinates, options );
 
 %--------------------------------------------------------------------------
 % Output Processing
@@ -105,10 +110,6 @@ face = face-1; pointPairs = pointPairs-1;
 % Add +1 to accound for MATLAB 1-indexing
 pointFaceLocations = pointFaceLocations + 1;
 
-% *************************************************************************
-% TODO: CREATE MAP FROM SORTED BOND LIST TO INPUT BOND LIST
-% *************************************************************************
-
 % Assemble cell location struct -------------------------------------------
 
 pfl_Cell = cell( sizepc(1), 1 );
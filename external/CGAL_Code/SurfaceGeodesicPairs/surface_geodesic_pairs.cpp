@@ -6,6 +6,9 @@
  * 	of a 3D triangulation.  The points are assumed to elements of face interiors, 
  * 	i.e. not vertices or elements of edges.
  *
+ * 	An optional options struct may contain 'lengthsOnly', to return only the geodesic
+ * 	lengths (4th output) without the point sequences, and 'numThreads'.
+ *
  * 	by Dillon Cislo
  * 	01/30/2019
  *
@@ -17,6 +20,14 @@
 
 #include <cstdlib>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <CGAL/Exact_predicates_inexact_constructions_kernel.h>
 #include <CGAL/Surface_mesh.h>
@@ -56,50 +67,106 @@ typedef CGAL::AABB_traits<Kernel, AABB_primitive> 				AABB_traits;
 typedef CGAL::AABB_tree<AABB_traits> 						AABB_tree;
 
 ///
-/// Calculates the surface geodesics between pairs of points on a mesh triangulation
+/// Calculates the surface geodesics between pairs of points on a mesh triangulation.
+/// Bonds are grouped by their source point so that the sequence tree of each source
+/// is built only once. Source groups are independent and are distributed over the
+/// OpenMP threads, each with its own shortest path object on the shared mesh.
 ///
-std::vector< std::vector<Point_3> > calculate_geodesic_pairs(
-		Surface_mesh_shortest_path &shortest_paths,
-		const std::vector< std::pair<std::size_t, std::size_t> > bondIDx,
-		const std::vector<Face_location> cell_locations ) {
+void calculate_geodesic_pairs(
+		const Triangle_mesh &tmesh,
+		const std::vector< std::pair<std::size_t, std::size_t> > &bondIDx,
+		const std::vector<Face_location> &cell_locations,
+		bool lengthsOnly, unsigned int numThreads,
+		std::vector< std::vector<Point_3> > &geodesic_pairs,
+		std::vector<double> &geodesic_lengths ) {
+
+	std::size_t numBonds = bondIDx.size();
+	geodesic_pairs.assign( lengthsOnly ? 0 : numBonds, std::vector<Point_3>() );
+	geodesic_lengths.assign( numBonds, std::numeric_limits<double>::quiet_NaN() );
+	if ( numBonds == 0 ) return;
+
+	// Group the bonds by source -----------------------------------------------------------
+	std::vector<std::size_t> order( numBonds );
+	for( std::size_t i = 0; i < numBonds; i++ ) order[i] = i;
+
+	std::stable_sort( order.begin(), order.end(),
+			[&bondIDx]( std::size_t a, std::size_t b ) {
+				return bondIDx[a].first < bondIDx[b].first; } );
+
+	// Bonds order[ groupStart[g] ] ... order[ groupStart[g+1]-1 ] share the same source
+	std::vector<std::size_t> groupStart;
+	for( std::size_t k = 0; k < numBonds; k++ ) {
+
+		if ( k == 0 || bondIDx[ order[k] ].first != bondIDx[ order[k-1] ].first )
+			groupStart.push_back( k );
 
-	// Construct the output vector
-	std::vector< std::vector<Point_3> > geodesic_pairs;
-	geodesic_pairs.reserve( bondIDx.size() );
-
-	// Iterate over the bonds to construct the geodesic paths ------------------------------
-	
-	// Remove any existing source points
-	if ( shortest_paths.number_of_source_points() != 0 ) {
-		shortest_paths.remove_all_source_points();
 	}
+	std::size_t numGroups = groupStart.size();
+	groupStart.push_back( numBonds );
 
-	// Add the source point of the first bond
-	shortest_paths.add_source_point( cell_locations[ bondIDx[0].first ] );
+	// Process the source groups on the worker pool ----------------------------------------
+#ifdef _OPENMP
+	if ( numThreads == 0 ) numThreads = omp_get_max_threads();
+#else
+	numThreads = 1;
+#endif
+	numThreads = (unsigned int) std::max<std::size_t>( 1, std::min<std::size_t>( numThreads, numGroups ) );
 
-	for( int i = 0; i < bondIDx.size(); i++ ) {
+	std::string error;
 
-		// Update the current source if it is not an element of the current bond
-		Face_location currentSourceLocation = *shortest_paths.source_points_begin();
+	#pragma omp parallel num_threads( numThreads )
+	{
 
-		if( currentSourceLocation != cell_locations[ bondIDx[i].first ] ) {
+		// Each thread owns a shortest path object, the mesh is only read
+		Surface_mesh_shortest_path shortest_paths( tmesh );
 
-			shortest_paths.remove_all_source_points();
-			shortest_paths.add_source_point( cell_locations[ bondIDx[i].first ] );
+		#pragma omp for schedule( dynamic )
+		for( long g = 0; g < (long) numGroups; g++ ) {
 
-		}
+			try {
+
+				const Face_location &source = cell_locations[ bondIDx[ order[ groupStart[g] ] ].first ];
+
+				shortest_paths.remove_all_source_points();
+				shortest_paths.add_source_point( source );
+				shortest_paths.build_sequence_tree();
+
+				for( std::size_t k = groupStart[g]; k < groupStart[g+1]; k++ ) {
+
+					std::size_t i = order[k];
+					const Face_location &target = cell_locations[ bondIDx[i].second ];
 
-		std::vector<Point_3> currentBond;
-		shortest_paths.shortest_path_points_to_source_points(
-				cell_locations[ bondIDx[i].second ].first,
-				cell_locations[ bondIDx[i].second ].second,
-				std::back_inserter( currentBond ) );
+					// Negative if the target cannot be reached from the source
+					double length = CGAL::to_double(
+							shortest_paths.shortest_distance_to_source_points(
+								target.first, target.second ).first );
+					if ( length >= 0 ) geodesic_lengths[i] = length;
 
-		geodesic_pairs.push_back( currentBond );
+					if ( !lengthsOnly ) {
+
+						shortest_paths.shortest_path_points_to_source_points(
+								target.first, target.second,
+								std::back_inserter( geodesic_pairs[i] ) );
+
+					}
+
+				}
+
+			} catch ( const std::exception &e ) {
+
+				#pragma omp critical
+				error = e.what();
+
+			}
+
+		}
 
 	}
 
-	return geodesic_pairs;
+	if ( !error.empty() ) {
+		mexErrMsgIdAndTxt( "MATLAB:surface_geodesic_pairs:geodesic",
+				"Geodesic computation failed: %s", error.c_str() );
+	}
 
 };
 	
@@ -114,12 +181,12 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	// -------------------------------------------------------------------------------------
 	
 	// Check for proper number of arguments
-	if ( nrhs != 4 ) {
+	if ( nrhs != 4 && nrhs != 5 ) {
 		mexErrMsgIdAndTxt( "MATLAB:surface_geodesic_pairs:nargin",
-				"SURFACE_GEODESIC_PAIRS requires five input arguments." );
-	} else if ( nlhs != 3 ) {
+				"SURFACE_GEODESIC_PAIRS requires four or five input arguments." );
+	} else if ( nlhs != 3 && nlhs != 4 ) {
 		mexErrMsgIdAndTxt( "MATLAB:surface_geodesic_pairs:nargout",
-				"SURFACE_GEODESIC_PAIRS requires one output argument." );
+				"SURFACE_GEODESIC_PAIRS requires three or four output arguments." );
 	}
 
 	// The face connectivity list
@@ -166,6 +233,28 @@ void mexFunction( int nlhs, mxArray *plhs[],
 				"Cell coordinates must be 3D." );
 	}
 
+	// Optional parameters: only compute the geodesic lengths, number of worker threads
+	bool lengthsOnly = false;
+	unsigned int numThreads = 0;
+	if ( nrhs == 5 ) {
+
+		if ( !mxIsStruct( prhs[4] ) ) {
+			mexErrMsgIdAndTxt( "MATLAB:surface_geodesic_pairs:options",
+					"Options must be supplied as a struct." );
+		}
+
+		int idx;
+		if ( ( idx = mxGetFieldNumber( prhs[4], "lengthsOnly" ) ) != -1 ) {
+			// mxGetScalar accepts a logical as well as a double flag
+			lengthsOnly = ( mxGetScalar( mxGetFieldByNumber( prhs[4], 0, idx ) ) != 0 );
+		}
+
+		if ( ( idx = mxGetFieldNumber( prhs[4], "numThreads" ) ) != -1 ) {
+			numThreads = (unsigned int) mxGetScalar( mxGetFieldByNumber( prhs[4], 0, idx ) );
+		}
+
+	}
+
 	// Re-format the bond ID pair list -----------------------------------------------------
 	std::vector< std::pair<std::size_t, std::size_t> > bondIDx;
 	bondIDx.reserve( numBonds );
@@ -210,12 +299,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	CGAL::Polygon_mesh_processing::orient_polygon_soup( points, polygons );
 	CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh( points, polygons, tmesh );
 	
-	// Create the Surface_mesh_shortest_path object ----------------------------------------
-	Surface_mesh_shortest_path shortest_paths( tmesh );
-
 	// Find the face locations of each cell centroid ---------------------------------------
 	
-	// Cache the AABB tree object
+	// Build the AABB tree once, it is only read afterwards
+	Surface_mesh_shortest_path shortest_paths( tmesh );
 	AABB_tree tree;
 	shortest_paths.build_aabb_tree( tree );
 
@@ -237,18 +324,20 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	// -------------------------------------------------------------------------------------
 	
 	std::vector< std::vector<Point_3> > geodesic_pairs;
-	geodesic_pairs = calculate_geodesic_pairs( shortest_paths, bondIDx, cell_locations );
+	std::vector<double> geodesic_lengths;
+	calculate_geodesic_pairs( tmesh, bondIDx, cell_locations, lengthsOnly, numThreads,
+			geodesic_pairs, geodesic_lengths );
 
 	// -------------------------------------------------------------------------------------
 	// OUTPUT PROCESSING
 	// -------------------------------------------------------------------------------------
 	
-	// Create geodesic_path output cell array ----------------------------------------------
-	plhs[0] = mxCreateCellMatrix( numBonds, 1 );
+	// Create geodesic_path output cell array, empty if only the lengths are computed -----
+	plhs[0] = mxCreateCellMatrix( lengthsOnly ? 0 : numBonds, 1 );
 
-	for( int i = 0; i < numBonds; i++ ) {
+	for( int i = 0; i < geodesic_pairs.size(); i++ ) {
 
-		std::vector<Point_3> currentGeodesic = geodesic_pairs[i];
+		const std::vector<Point_3> &currentGeodesic = geodesic_pairs[i];
 		int numPoints = currentGeodesic.size();
 
 		mxArray *pointSequenceOut = mxCreateDoubleMatrix( numPoints, 3, mxREAL );
@@ -275,7 +364,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
 
 	for( int i = 0; i < numCells; i++ ) {
 
-		Face_location currentCell = cell_locations[i];
+		const Face_location &currentCell = cell_locations[i];
 
 		cellIndexOut[i] = (double) currentCell.first;
 
@@ -285,6 +374,16 @@ void mexFunction( int nlhs, mxArray *plhs[],
 
 	}
 
+	// Create geodesic length output, NaN for unreachable pairs ----------------------------
+	
+	if ( nlhs == 4 ) {
+
+		plhs[3] = mxCreateDoubleMatrix( numBonds, 1, mxREAL );
+		double *lengthOut = mxGetPr( plhs[3] );
+		for( int i = 0; i < numBonds; i++ ) lengthOut[i] = geodesic_lengths[i];
+
+	}
+
 	return;
 
 };
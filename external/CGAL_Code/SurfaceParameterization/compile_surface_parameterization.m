@@ -1,3 +1,3 @@
 function compile_surface_parameterization
-    mex -v -O surface_parameterization.cpp -I/usr/include:/usr/local/include -L/usr/lib:/usr/local/lib -lCGAL -lgmp -lboost_thread
+    mex -v -O surface_parameterization.cpp -I/usr/include:/usr/local/include -I/usr/include/eigen3 -I/usr/local/include/eigen3 -L/usr/lib:/usr/local/lib -lCGAL -lgmp -lboost_thread
 end
\ No newline at end of file
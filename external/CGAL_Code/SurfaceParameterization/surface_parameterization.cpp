@@ -16,8 +16,11 @@
 #include "mex.h" // for MATLAB
 
 #include <cstdlib>
+#include <cmath>
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 
 #include <CGAL/Simple_cartesian.h> 
 #include <CGAL/Surface_mesh.h>
@@ -55,6 +58,10 @@
 #include <boost/function_output_iterator.hpp>
 #include <boost/foreach.hpp>
 
+#include <Eigen/Geometry>
+#include <Eigen/Sparse>
+#include <Eigen/SparseCholesky>
+
 typedef CGAL::Simple_cartesian<double>                   Kernel;
 typedef Kernel::Point_2                                  Point_2;
 typedef Kernel::Point_3                                  Point_3;
@@ -279,46 +286,487 @@ void parameterize_free_border( SMP::Error_code &err, Mesh &mesh, UV_pmap &uvMap,
 };
 
 
+///
+/// As-rigid-as-possible local/global solver for a sequence of frames sharing the
+/// same connectivity. The sparsity pattern of the global system and its symbolic
+/// factorization only depend on the connectivity and the pinned vertices, so they
+/// are computed once. The cotangent weights change with the geometry, so the
+/// numerical factorization is redone once per frame and then reused by every global
+/// step of that frame. The loop starts from the (u,v)-coordinates it is given, e.g.
+/// the parameterization of the previous frame.
+///
+class ARAP_solver {
+
+  public:
+
+    typedef Eigen::SparseMatrix<double> SpMat;
+    typedef Eigen::Matrix<double, Eigen::Dynamic, 2> UVMat;
+
+    ARAP_solver() : numVertex( 0 ), numFree( 0 ), analyzed( false ), energy( 0.0 ) {};
+
+    ///
+    /// Set up the sparsity pattern of the global system. 'tri' holds the
+    /// zero-indexed vertices of each (consistently oriented) triangle and the
+    /// pinned vertices keep their initial (u,v)-coordinates. Vertices that no
+    /// triangle uses would have empty rows, so they are pinned as well
+    ///
+    void initialize( const std::vector<std::size_t> &tri, std::size_t nV,
+        const std::vector<std::size_t> &pinned ) {
+
+      triangles = tri;
+      numVertex = nV;
+
+      freeIndex.assign( numVertex, -2 );
+      for( std::size_t i = 0; i < triangles.size(); i++ ) freeIndex[triangles[i]] = -1;
+      for( std::size_t k = 0; k < pinned.size(); k++ ) freeIndex[pinned[k]] = -2;
+
+      numFree = 0;
+      for( std::size_t v = 0; v < numVertex; v++ ) {
+        if ( freeIndex[v] == -1 ) { freeIndex[v] = (int) numFree++; }
+        else { freeIndex[v] = -1; }
+      }
+
+      // Only the lower triangle is stored, that is all SimplicialLDLT reads
+      std::size_t numTri = triangles.size() / 3;
+      std::vector< Eigen::Triplet<double> > triplets;
+      triplets.reserve( 9 * numTri );
+      for( std::size_t t = 0; t < numTri; t++ ) {
+        for( int k = 0; k < 3; k++ ) {
+          int fi = freeIndex[ triangles[3*t+k] ];
+          int fj = freeIndex[ triangles[3*t+(k+1)%3] ];
+          if ( fi >= 0 ) triplets.push_back( Eigen::Triplet<double>( fi, fi, 1.0 ) );
+          if ( fj >= 0 ) triplets.push_back( Eigen::Triplet<double>( fj, fj, 1.0 ) );
+          if ( fi >= 0 && fj >= 0 ) triplets.push_back(
+              Eigen::Triplet<double>( std::max(fi, fj), std::min(fi, fj), 1.0 ) );
+        }
+      }
+
+      A.resize( numFree, numFree );
+      A.setFromTriplets( triplets.begin(), triplets.end() );
+      A.makeCompressed();
+
+      // Position of each edge contribution in the value array of A, so that the
+      // matrix of a new frame is assembled without touching its structure
+      valueIndex.assign( 9 * numTri, -1 );
+      for( std::size_t t = 0; t < numTri; t++ ) {
+        for( int k = 0; k < 3; k++ ) {
+          int fi = freeIndex[ triangles[3*t+k] ];
+          int fj = freeIndex[ triangles[3*t+(k+1)%3] ];
+          int *pos = &valueIndex[9*t+3*k];
+          if ( fi >= 0 ) pos[0] = (int) ( &A.coeffRef( fi, fi ) - A.valuePtr() );
+          if ( fj >= 0 ) pos[1] = (int) ( &A.coeffRef( fj, fj ) - A.valuePtr() );
+          if ( fi >= 0 && fj >= 0 ) pos[2] = (int) ( &A.coeffRef(
+                std::max(fi, fj), std::min(fi, fj) ) - A.valuePtr() );
+        }
+      }
+
+      analyzed = false;
+
+    };
+
+    ///
+    /// Load the 3D coordinates of a frame (a MATLAB #V x 3 array), assemble the
+    /// cotangent Laplacian in place and factorize it
+    ///
+    bool set_geometry( const double *vertex ) {
+
+      std::size_t numTri = triangles.size() / 3;
+      localCoords.resize( 6 * numTri );
+      cotWeights.resize( 3 * numTri );
+
+      for( std::size_t t = 0; t < numTri; t++ ) {
+
+        Eigen::Vector3d p[3];
+        for( int k = 0; k < 3; k++ ) {
+          std::size_t v = triangles[3*t+k];
+          p[k] = Eigen::Vector3d( vertex[v], vertex[v+numVertex], vertex[v+2*numVertex] );
+        }
+
+        // Isometric copy of the triangle in the plane
+        Eigen::Vector3d e1 = p[1]-p[0];
+        Eigen::Vector3d e2 = p[2]-p[0];
+        double l1 = e1.norm();
+        double *x = &localCoords[6*t];
+        x[0] = 0.0; x[1] = 0.0;
+        x[2] = l1;  x[3] = 0.0;
+        x[4] = ( l1 > 0.0 ) ? e1.dot(e2) / l1 : 0.0;
+        x[5] = ( l1 > 0.0 ) ? e1.cross(e2).norm() / l1 : 0.0;
+
+        // Cotangent of the angle opposite to each edge (k, k+1)
+        for( int k = 0; k < 3; k++ ) {
+          Eigen::Vector3d a = p[k]-p[(k+2)%3];
+          Eigen::Vector3d b = p[(k+1)%3]-p[(k+2)%3];
+          double s = a.cross(b).norm();
+          cotWeights[3*t+k] = ( s > 0.0 ) ? a.dot(b) / s : 0.0;
+        }
+
+      }
+
+      double *values = A.valuePtr();
+      std::fill( values, values + A.nonZeros(), 0.0 );
+      for( std::size_t t = 0; t < numTri; t++ ) {
+        for( int k = 0; k < 3; k++ ) {
+          double w = cotWeights[3*t+k];
+          const int *pos = &valueIndex[9*t+3*k];
+          if ( pos[0] >= 0 ) values[pos[0]] += w;
+          if ( pos[1] >= 0 ) values[pos[1]] += w;
+          if ( pos[2] >= 0 ) values[pos[2]] -= w;
+        }
+      }
+
+      if ( !analyzed ) {
+        solver.analyzePattern( A );
+        analyzed = true;
+      }
+      solver.factorize( A );
+
+      return solver.info() == Eigen::Success;
+
+    };
+
+    ///
+    /// Run local/global iterations starting from the (u,v)-coordinates in 'uv'
+    /// (a MATLAB #V x 2 array, updated in place) until the relative decrease of
+    /// the energy falls below 'tolerance'. Returns the number of global steps
+    ///
+    int solve( double *uv, int maxIterations, double tolerance ) {
+
+      std::size_t numTri = triangles.size() / 3;
+      std::vector<double> rotations( 2 * numTri );
+      UVMat b( numFree, 2 );
+
+      double lastEnergy = 0.0;
+      int iter = 0;
+
+      while ( true ) {
+
+        // Local step: closest rotation to the Jacobian of each triangle
+        energy = 0.0;
+        for( std::size_t t = 0; t < numTri; t++ ) {
+
+          const double *x = &localCoords[6*t];
+          double S00 = 0.0, S01 = 0.0, S10 = 0.0, S11 = 0.0;
+          for( int k = 0; k < 3; k++ ) {
+            std::size_t i = triangles[3*t+k];
+            std::size_t j = triangles[3*t+(k+1)%3];
+            int kk = (k+1)%3;
+            double w = cotWeights[3*t+k];
+            double du = uv[i]-uv[j], dv = uv[i+numVertex]-uv[j+numVertex];
+            double dx = x[2*k]-x[2*kk], dy = x[2*k+1]-x[2*kk+1];
+            S00 += w*du*dx; S01 += w*du*dy;
+            S10 += w*dv*dx; S11 += w*dv*dy;
+          }
+
+          double c = S00+S11, s = S10-S01;
+          double r = std::sqrt( c*c + s*s );
+          if ( r > 0.0 ) { c /= r; s /= r; } else { c = 1.0; s = 0.0; }
+          rotations[2*t] = c;
+          rotations[2*t+1] = s;
+
+          for( int k = 0; k < 3; k++ ) {
+            std::size_t i = triangles[3*t+k];
+            std::size_t j = triangles[3*t+(k+1)%3];
+            int kk = (k+1)%3;
+            double w = cotWeights[3*t+k];
+            double dx = x[2*k]-x[2*kk], dy = x[2*k+1]-x[2*kk+1];
+            double eu = uv[i]-uv[j] - (c*dx - s*dy);
+            double ev = uv[i+numVertex]-uv[j+numVertex] - (s*dx + c*dy);
+            energy += w * ( eu*eu + ev*ev );
+          }
+
+        }
+
+        if ( iter >= maxIterations ) break;
+        if ( iter > 0 && std::abs( lastEnergy - energy ) <= tolerance * lastEnergy ) break;
+        lastEnergy = energy;
+
+        // Global step: Poisson problem for the rotated triangle edges
+        b.setZero();
+        for( std::size_t t = 0; t < numTri; t++ ) {
+
+          const double *x = &localCoords[6*t];
+          double c = rotations[2*t], s = rotations[2*t+1];
+          for( int k = 0; k < 3; k++ ) {
+            std::size_t i = triangles[3*t+k];
+            std::size_t j = triangles[3*t+(k+1)%3];
+            int kk = (k+1)%3;
+            int fi = freeIndex[i], fj = freeIndex[j];
+            double w = cotWeights[3*t+k];
+            double dx = x[2*k]-x[2*kk], dy = x[2*k+1]-x[2*kk+1];
+            double ru = w * (c*dx - s*dy), rv = w * (s*dx + c*dy);
+            if ( fi >= 0 ) {
+              b(fi, 0) += ru; b(fi, 1) += rv;
+              if ( fj < 0 ) { b(fi, 0) += w*uv[j]; b(fi, 1) += w*uv[j+numVertex]; }
+            }
+            if ( fj >= 0 ) {
+              b(fj, 0) -= ru; b(fj, 1) -= rv;
+              if ( fi < 0 ) { b(fj, 0) += w*uv[i]; b(fj, 1) += w*uv[i+numVertex]; }
+            }
+          }
+
+        }
+
+        UVMat X = solver.solve( b );
+        for( std::size_t v = 0; v < numVertex; v++ ) {
+          if ( freeIndex[v] < 0 ) continue;
+          uv[v] = X(freeIndex[v], 0);
+          uv[v+numVertex] = X(freeIndex[v], 1);
+        }
+
+        iter++;
+
+      }
+
+      return iter;
+
+    };
+
+    /// ARAP energy of the last solution
+    double get_energy() const { return energy; };
+
+  private:
+
+    std::vector<std::size_t> triangles;
+    std::size_t numVertex;
+    std::size_t numFree;
+    std::vector<int> freeIndex;     // Row of each vertex in the system, -1 if pinned
+    std::vector<int> valueIndex;    // Position of the edge contributions in A
+
+    std::vector<double> localCoords;
+    std::vector<double> cotWeights;
+
+    SpMat A;
+    Eigen::SimplicialLDLT<SpMat> solver;
+    bool analyzed;
+    double energy;
+
+};
+
+///
+/// Create the oriented surface mesh from MATLAB face/vertex arrays
+///
+void build_mesh( Mesh &mesh, const double *faces, std::size_t numFaces,
+    std::size_t sizeFaces, const double *vertex, std::size_t numVertex ) {
+
+	// Create vector of 3D point objects
+	std::vector<Point_3> points;
+	points.reserve( numVertex );
+	for( int i = 0; i < numVertex; i++ ) {
+
+		points.push_back( Point_3( vertex[i],
+					 vertex[i+numVertex],
+					 vertex[i+(2*numVertex)] ) );
+
+	}
+
+	// Create vector of polygon objects
+	std::vector< std::vector<std::size_t> > polygons;
+	polygons.reserve( numFaces );
+	for( int i = 0; i < numFaces; i++ ) {
+
+		std::vector<std::size_t> currentPolygon;
+		currentPolygon.reserve( sizeFaces );
+		for( int j = 0; j < sizeFaces; j++ ) {
+
+			// NOTE: We subtract 1 from the index to account for
+			// MATLAB's 1-indexed array structures
+			double index = faces[i+(j*numFaces)]-1.0;
+			currentPolygon.push_back( (std::size_t) index );
+
+		}
+
+		polygons.push_back( currentPolygon );
+
+	}
+
+	// Populate the mesh
+  mesh.clear();
+  CGAL::Polygon_mesh_processing::orient_polygon_soup( points, polygons );
+  CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh( points, polygons, mesh );
+
+};
+
+///
+/// Move the vertices of a mesh built by build_mesh to the coordinates of a new frame
+///
+void update_mesh_points( Mesh &mesh, const double *vertex, std::size_t numVertex ) {
+
+  BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+    std::size_t i = (std::size_t) v;
+    mesh.point(v) = Point_3( vertex[i], vertex[i+numVertex], vertex[i+(2*numVertex)] );
+  }
+
+};
+
+///
+/// Copy the (u,v)-coordinates of the mesh vertices into a new #V x 2 MATLAB array
+///
+mxArray* uv_to_matlab( Mesh &mesh, UV_pmap &uvMap ) {
+
+  std::size_t numVertexFinal = mesh.number_of_vertices(); // Final number of vertices
+
+  mxArray *out = mxCreateDoubleMatrix( numVertexFinal, 2, mxREAL );
+  double *uvOut = mxGetPr( out );
+
+  // Collect (u,v)-coordinates
+  int i = 0;
+  BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+
+    Point_2 uv = uvMap[v];
+
+    uvOut[i] = (double) uv.x();
+    uvOut[i+numVertexFinal] = (double) uv.y();
+
+    i++;
+
+  }
+
+  return out;
+
+};
+
+///
+/// Copy the face connectivity of the mesh into a new #F x 3 MATLAB array
+///
+mxArray* faces_to_matlab( Mesh &mesh, std::size_t sizeFaces ) {
+
+  std::size_t numFacesFinal = mesh.number_of_faces(); // Final number of faces
+
+  mxArray *out = mxCreateDoubleMatrix( numFacesFinal, sizeFaces, mxREAL );
+  double *facesOut = mxGetPr( out );
+
+	// Collect face quantities
+	int i = 0;
+	BOOST_FOREACH( Face_index f, mesh.faces() ) {
+
+		// Iterate around the current face to find connectivity
+		int j = 0;
+		BOOST_FOREACH( Vertex_index v, vertices_around_face(mesh.halfedge(f), mesh) ) {
+
+			// NOTE: We add 1 to the index to account for
+			// MATLAB's 1-indexed array structures
+			facesOut[i+(j*numFacesFinal)] = (double) v+1.0;
+			j++;
+
+		}
+
+		i++;
+
+	}
+
+  return out;
+
+};
+
+///
+/// Zero-indexed vertices of each face of the mesh, in a flat array
+///
+std::vector<std::size_t> mesh_triangles( Mesh &mesh ) {
+
+  std::vector<std::size_t> tri;
+  tri.reserve( 3 * mesh.number_of_faces() );
+  BOOST_FOREACH( Face_index f, mesh.faces() ) {
+    BOOST_FOREACH( Vertex_index v, vertices_around_face(mesh.halfedge(f), mesh) ) {
+      tri.push_back( (std::size_t) v );
+    }
+  }
+
+  return tri;
+
+};
+
+///
+/// Check that two MATLAB face lists describe the same connectivity
+///
+bool same_connectivity( const mxArray *F1, const mxArray *F2 ) {
+
+  if ( F1 == F2 ) return true;
+  if ( mxGetM(F1) != mxGetM(F2) || mxGetN(F1) != mxGetN(F2) ) return false;
+
+  return std::equal( mxGetPr(F1), mxGetPr(F1) + mxGetNumberOfElements(F1), mxGetPr(F2) );
+
+};
+
+
 ///
 /// Brief main function to call computational functionalities
 ///
+/// [UV, F] = surface_parameterization( F, V, options ) parameterizes a single mesh.
+///
+/// [UV, F, info] = surface_parameterization( F, {V1, V2, ...}, options ) runs the
+/// time-series mode: each cell of the second argument is a frame of the same surface.
+/// F is either a single face list shared by all frames or a cell array with one face
+/// list per frame. UV and F are then cell arrays with one entry per frame. The mesh is
+/// only rebuilt when the connectivity changes between consecutive frames. With ARAP,
+/// each frame starts from the parameterization of the previous one and the sparsity
+/// pattern and symbolic factorization of the global system are reused; the first frame
+/// (and any frame after a change of connectivity) starts from LSCM, or from
+/// options.initialUV when it is supplied. options.initialUV also warm-starts ARAP for a
+/// single mesh.
+///
+/// 'info' reports, for each frame, the solve time in seconds, the number of ARAP
+/// global steps (0 for the direct methods, NaN when CGAL's own ARAP loop is used), the
+/// final ARAP energy (NaN for the other methods) and whether the mesh and factorization
+/// pattern of the previous frame were reused.
+///
 void mexFunction( int nlhs, mxArray *plhs[],
     int nrhs, const mxArray *prhs[] ) {
 
   // -------------------------------------------------------------------------------------------
   // INPUT PROCESSING
   // -------------------------------------------------------------------------------------------
-  
+
   // Check for proper number of arguments
   if ( nrhs != 3 ) {
     mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:nargin",
         "SURFACE_PARMETERIZATION requires three input arguments." );
-  } else if ( nlhs != 2 ) {
+  } else if ( nlhs < 2 || nlhs > 3 ) {
     mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:nargout",
-        "SURFACE_PARMETERIZATION requres two output arguments." );
+        "SURFACE_PARMETERIZATION requres two or three output arguments." );
+  }
+
+  // Collect the frames. A single mesh is a time series of one frame
+  bool timeSeries = mxIsCell( prhs[1] );
+  std::size_t numFrames = timeSeries ? mxGetNumberOfElements( prhs[1] ) : 1;
+
+  if ( timeSeries && numFrames == 0 ) {
+    mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:frames",
+        "The time series must contain at least one frame." );
   }
 
-  double *faces = mxGetPr( prhs[0] );         // The face connectivity list
-  std::size_t numFaces = mxGetM( prhs[0] );   // The number of faces
-  std::size_t sizeFaces = mxGetN( prhs[0] );  // The number of vertices in a single face
+  if ( mxIsCell( prhs[0] ) &&
+      ( !timeSeries || mxGetNumberOfElements( prhs[0] ) != numFrames ) ) {
+    mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:frames",
+        "A cell array of face lists must have one entry per frame." );
+  }
 
+  std::vector<const mxArray*> frameFaces( numFrames );
+  std::vector<const mxArray*> frameVertex( numFrames );
+  for( std::size_t k = 0; k < numFrames; k++ ) {
 
-  // Check that the input mesh is a triangulation
-	if ( sizeFaces != 3 ) {
-		mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:face_dim",
-				"Input mesh must be a triangulation." );
-	}
+    frameFaces[k] = mxIsCell( prhs[0] ) ? mxGetCell( prhs[0], k ) : prhs[0];
+    frameVertex[k] = timeSeries ? mxGetCell( prhs[1], k ) : prhs[1];
 
+    if ( frameFaces[k] == NULL || frameVertex[k] == NULL ) {
+      mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:frames",
+          "Every frame must have a face list and a vertex list." );
+    }
 
-	double *vertex = mxGetPr( prhs[1] ); 	      // The vertex coordinate list
-	std::size_t numVertex = mxGetM( prhs[1] );  // The number of vertices
-	std::size_t dim = mxGetN( prhs[1] ); 	      // The dimensionality of the vertex list
+    // Check that the input mesh is a triangulation
+    if ( mxGetN( frameFaces[k] ) != 3 ) {
+      mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:face_dim",
+          "Input mesh must be a triangulation." );
+    }
 
-	// Check the dimensionality of the vertex list
-	if ( dim != 3 ) {
-		mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:vertex_dim",
-				"Vertex coordinates must be 3D." );
-	}
+    // Check the dimensionality of the vertex list
+    if ( mxGetN( frameVertex[k] ) != 3 ) {
+      mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:vertex_dim",
+          "Vertex coordinates must be 3D." );
+    }
+
+  }
+
+  std::size_t sizeFaces = 3;  // The number of vertices in a single face
 
   // Default parameterization settings
   int idx;
@@ -327,7 +775,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
   int fixedType = ARC_LENGTH;
   int fixedShape = CIRCLE;
   int paramMethod = CONFORMAL;
-  
+
   bool cornersSupplied = false;
   std::vector<vertex_descriptor> corners;
   corners.reserve( 4 );
@@ -338,6 +786,11 @@ void mexFunction( int nlhs, mxArray *plhs[],
   xPts.reserve( 2 );
   double *xPtsIn;
 
+  // Settings of the warm-started ARAP solver (CGAL's defaults)
+  const mxArray *initialUV = NULL;
+  int maxIterations = 50;
+  double tolerance = 1e-6;
+
   if ( ( idx = mxGetFieldNumber( prhs[2], "borderType" ) ) != -1 ) {
     borderType = (int) *mxGetPr(mxGetFieldByNumber( prhs[2], 0, idx ));
   }
@@ -364,6 +817,19 @@ void mexFunction( int nlhs, mxArray *plhs[],
     xPtsIn = mxGetPr(mxGetFieldByNumber( prhs[2], 0, idx ));
   }
 
+  if ( ( idx = mxGetFieldNumber( prhs[2], "initialUV" ) ) != -1 ) {
+    initialUV = mxGetFieldByNumber( prhs[2], 0, idx );
+    if ( mxIsEmpty( initialUV ) ) initialUV = NULL;
+  }
+
+  if ( ( idx = mxGetFieldNumber( prhs[2], "maxIterations" ) ) != -1 ) {
+    maxIterations = (int) *mxGetPr(mxGetFieldByNumber( prhs[2], 0, idx ));
+  }
+
+  if ( ( idx = mxGetFieldNumber( prhs[2], "tolerance" ) ) != -1 ) {
+    tolerance = *mxGetPr(mxGetFieldByNumber( prhs[2], 0, idx ));
+  }
+
   if ( cornersSupplied ) {
     for( int i = 0; i < 4; i++ ) {
       corners.push_back( (vertex_descriptor) (cornersIn[i]-1) );
@@ -376,123 +842,188 @@ void mexFunction( int nlhs, mxArray *plhs[],
     }
   }
 
-	// Create and populate the polyhedral mesh ---------------------------------------------
-	
-	// Create vector of 3D point objects
-	std::vector<Point_3> points;
-	points.reserve( numVertex );
-	for( int i = 0; i < numVertex; i++ ) {
+  if ( borderType != FIXED && borderType != FREE ) {
+    mexErrMsgTxt("Invalid border type provided!");
+  }
 
-		points.push_back( Point_3( vertex[i],
-					 vertex[i+numVertex],
-					 vertex[i+(2*numVertex)] ) );
+  // The warm-started ARAP loop replaces CGAL's own whenever it has an initial
+  // iterate, i.e. for all time series and for single meshes given options.initialUV
+  bool warmARAP = ( borderType == FREE ) && ( paramMethod == ARAP ) &&
+    ( timeSeries || initialUV != NULL );
 
-	}
+  // -------------------------------------------------------------------------------------------
+  // MESH PROCESSING
+  // -------------------------------------------------------------------------------------------
 
-	// Create vector of polygon objects
-	std::vector< std::vector<std::size_t> > polygons;
-	polygons.reserve( numFaces );
-	for( int i = 0; i < numFaces; i++ ) {
+  Mesh mesh;
+  halfedge_descriptor bhd;
+  UV_pmap uvMap;
+  ARAP_solver arap;
 
-		std::vector<std::size_t> currentPolygon;
-		currentPolygon.reserve( sizeFaces );
-		for( int j = 0; j < sizeFaces; j++ ) {
+  // The (u,v)-coordinates carried from one frame to the next, #V x 2
+  std::vector<double> uv;
 
-			// NOTE: We subtract 1 from the index to account for
-			// MATLAB's 1-indexed array structures
-			double index = faces[i+(j*numFaces)]-1.0;
-			currentPolygon.push_back( (std::size_t) index );
+  std::vector<mxArray*> uvOut( numFrames );
+  std::vector<mxArray*> facesOut( numFrames );
+  std::vector<double> solveTime( numFrames );
+  std::vector<double> iterations( numFrames );
+  std::vector<double> energy( numFrames );
+  std::vector<double> reused( numFrames );
 
-		}
+  for( std::size_t k = 0; k < numFrames; k++ ) {
 
-		polygons.push_back( currentPolygon );
+    const double *faces = mxGetPr( frameFaces[k] );     // The face connectivity list
+    std::size_t numFaces = mxGetM( frameFaces[k] );     // The number of faces
+    const double *vertex = mxGetPr( frameVertex[k] );   // The vertex coordinate list
+    std::size_t numVertex = mxGetM( frameVertex[k] );   // The number of vertices
 
-	}
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
 
-	// Populate the mesh
-	Mesh mesh;
-  CGAL::Polygon_mesh_processing::orient_polygon_soup( points, polygons );
-  CGAL::Polygon_mesh_processing::polygon_soup_to_polygon_mesh( points, polygons, mesh );
+    bool reuse = ( k > 0 ) && same_connectivity( frameFaces[k], frameFaces[k-1] ) &&
+      ( numVertex == mxGetM( frameVertex[k-1] ) );
 
-  // -------------------------------------------------------------------------------------------
-  // MESH PROCESSING
-  // -------------------------------------------------------------------------------------------
-  
-  // A halfedge on the boundary
-  halfedge_descriptor bhd = CGAL::Polygon_mesh_processing::longest_border( mesh ).first;
+    if ( reuse ) {
 
-  // The 2D points of the (uv)-parameterization will be written to this property map
-  UV_pmap uvMap = mesh.add_property_map<vertex_descriptor, Point_2>
-    ("v:uv", Point_2(0,0)).first;
+      update_mesh_points( mesh, vertex, numVertex );
 
-  // Parameterize surface mesh
-  SMP::Error_code err;
+    } else {
 
-  if ( borderType == FIXED ) {
+      build_mesh( mesh, faces, numFaces, sizeFaces, vertex, numVertex );
 
-    parameterize_fixed_border( err, mesh, uvMap, bhd,
-        fixedType, fixedShape, paramMethod,
-        cornersSupplied, corners );
+      // A halfedge on the boundary
+      bhd = CGAL::Polygon_mesh_processing::longest_border( mesh ).first;
 
-  } else if ( borderType == FREE ) {
+      // The 2D points of the (uv)-parameterization will be written to this property map
+      uvMap = mesh.add_property_map<vertex_descriptor, Point_2>("v:uv", Point_2(0,0)).first;
 
-    parameterize_free_border( err, mesh, uvMap, bhd, paramMethod,
-        xPtsSupplied, xPts );
+      if ( ( timeSeries || warmARAP ) && mesh.number_of_vertices() != numVertex ) {
+        mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:manifold",
+            "Time series and warm starts require a mesh whose vertices are not "
+            "duplicated when the faces are oriented." );
+      }
 
-  } else {
+    }
 
-    mexErrMsgTxt("Invalid border type provided!");
+    // Parameterize surface mesh
+    SMP::Error_code err = SMP::OK;
 
-  }
+    if ( warmARAP ) {
 
-  if ( mesh.has_garbage() ) { mesh.collect_garbage(); }
+      // Initial iterate: the previous frame, the user's guess or LSCM
+      if ( !reuse ) {
 
-  // -------------------------------------------------------------------------------------------
-  // OUTPUT PROCESSING
-  // -------------------------------------------------------------------------------------------
-  
-  std::size_t numFacesFinal = mesh.number_of_faces(); // Final number of faces
-  std::size_t numVertexFinal = mesh.number_of_vertices(); // Final number of vertices
+        if ( k == 0 && initialUV != NULL ) {
 
-  plhs[0] = mxCreateDoubleMatrix( numVertexFinal, 2, mxREAL );
-  double *uvOut = mxGetPr( plhs[0] );
-  
-  plhs[1] = mxCreateDoubleMatrix( numFacesFinal, sizeFaces, mxREAL );
-  double *facesOut = mxGetPr( plhs[1] );
+          if ( mxGetM( initialUV ) != numVertex || mxGetN( initialUV ) != 2 ) {
+            mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:initialUV",
+                "The initial (u,v)-coordinates must be a #V x 2 array." );
+          }
+          uv.assign( mxGetPr( initialUV ), mxGetPr( initialUV ) + 2*numVertex );
 
-  // Collect (u,v)-coordinates
-  int i = 0;
-  BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+        } else {
 
-    Point_2 uv = uvMap[v];
+          parameterize_free_border( err, mesh, uvMap, bhd, LSCM, xPtsSupplied, xPts );
+          if ( err != SMP::OK ) mexErrMsgTxt( SMP::get_error_message( err ) );
 
-    uvOut[i] = (double) uv.x();
-    uvOut[i+numVertexFinal] = (double) uv.y();
+          uv.resize( 2*numVertex );
+          BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+            uv[(std::size_t) v] = uvMap[v].x();
+            uv[(std::size_t) v + numVertex] = uvMap[v].y();
+          }
 
-    i++;
+        }
+
+        // Pin the fixed points, or a single vertex of a face to remove the translations
+        std::vector<std::size_t> pinned;
+        if ( xPtsSupplied ) {
+          for( int i = 0; i < 2; i++ ) pinned.push_back( (std::size_t) xPts[i] );
+        } else {
+          BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+            if ( !mesh.is_isolated( v ) ) { pinned.push_back( (std::size_t) v ); break; }
+          }
+        }
+
+        arap.initialize( mesh_triangles( mesh ), numVertex, pinned );
+
+      }
+
+      if ( !arap.set_geometry( vertex ) ) {
+        mexErrMsgIdAndTxt( "MATLAB:surface_parameterization:factorization",
+            "Factorization of the ARAP system failed." );
+      }
+
+      iterations[k] = arap.solve( &uv[0], maxIterations, tolerance );
+      energy[k] = arap.get_energy();
+
+      BOOST_FOREACH( Vertex_index v, mesh.vertices() ) {
+        uvMap[v] = Point_2( uv[(std::size_t) v], uv[(std::size_t) v + numVertex] );
+      }
+
+    } else {
+
+      if ( borderType == FIXED ) {
+
+        parameterize_fixed_border( err, mesh, uvMap, bhd,
+            fixedType, fixedShape, paramMethod,
+            cornersSupplied, corners );
+
+      } else {
+
+        parameterize_free_border( err, mesh, uvMap, bhd, paramMethod,
+            xPtsSupplied, xPts );
+
+      }
+
+      iterations[k] = ( borderType == FREE && paramMethod == ARAP ) ? mxGetNaN() : 0.0;
+      energy[k] = mxGetNaN();
+
+    }
+
+    if ( mesh.has_garbage() ) { mesh.collect_garbage(); }
+
+    solveTime[k] = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start ).count();
+    reused[k] = reuse ? 1.0 : 0.0;
+
+    // ---------------------------------------------------------------------------------------
+    // OUTPUT PROCESSING
+    // ---------------------------------------------------------------------------------------
+
+    uvOut[k] = uv_to_matlab( mesh, uvMap );
+    facesOut[k] = faces_to_matlab( mesh, sizeFaces );
 
   }
 
-	// Collect face quantities
-	i = 0;
-	BOOST_FOREACH( Face_index f, mesh.faces() ) {
+  if ( timeSeries ) {
 
-		// Iterate around the current face to find connectivity
-		int j = 0;
-		BOOST_FOREACH( Vertex_index v, vertices_around_face(mesh.halfedge(f), mesh) ) {
+    plhs[0] = mxCreateCellMatrix( numFrames, 1 );
+    plhs[1] = mxCreateCellMatrix( numFrames, 1 );
+    for( std::size_t k = 0; k < numFrames; k++ ) {
+      mxSetCell( plhs[0], k, uvOut[k] );
+      mxSetCell( plhs[1], k, facesOut[k] );
+    }
 
-			// NOTE: We add 1 to the index to account for
-			// MATLAB's 1-indexed array structures
-			facesOut[i+(j*numFacesFinal)] = (double) v+1.0;
-			j++;
+  } else {
 
-		}
+    plhs[0] = uvOut[0];
+    plhs[1] = facesOut[0];
 
-		i++;
+  }
 
-	}
+  if ( nlhs == 3 ) {
+
+    const char *fieldNames[] = { "solveTime", "iterations", "energy", "reused" };
+    std::vector<double> *fields[] = { &solveTime, &iterations, &energy, &reused };
+
+    plhs[2] = mxCreateStructMatrix( 1, 1, 4, fieldNames );
+    for( int f = 0; f < 4; f++ ) {
+      mxArray *field = mxCreateDoubleMatrix( numFrames, 1, mxREAL );
+      std::copy( fields[f]->begin(), fields[f]->end(), mxGetPr( field ) );
+      mxSetFieldByNumber( plhs[2], 0, f, field );
+    }
+
+  }
 
   return;
 
 };
-
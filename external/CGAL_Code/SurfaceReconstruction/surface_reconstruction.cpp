@@ -93,6 +93,7 @@ void mexFunction( int nlhs, mxArray *plhs[],
 
   // Load input points into point set structure 
   Point_set points;
+  points.reserve( numPoints );
   for( int i = 0; i < numPoints; i++ ) {
 
 		Point_3 pp = Point_3( pts[i], pts[i+numPoints], pts[i+(2*numPoints)] );
@@ -262,7 +263,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
   
   
   std::vector<Facet> facets; // Output face connectivity list
-  std::vector<Point_3> vertices; // Output vertex coordinate list
 
   if (reconstruction_choice == ADVANCING_FRONT) {
 
@@ -270,12 +270,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
     CGAL::advancing_front_surface_reconstruction( points.points().begin(),
         points.points().end(), std::back_inserter(facets) );
 
-    // Copy points for random access
-    vertices.reserve( points.size() );
-    std::copy( points.points().begin(), points.points().end(),
-        std::back_inserter(vertices) );
-
-
   } else if (reconstruction_choice == SCALE_SPACE) {
 
     CGAL::Scale_space_surface_reconstruction_3<Kernel> reconstruct(
@@ -291,11 +285,6 @@ void mexFunction( int nlhs, mxArray *plhs[],
         CGAL::Scale_space_reconstruction_3::Advancing_front_mesher<Kernel>(
           ss_max_length) );
 
-    // Copy points for output
-    vertices.reserve( points.size() );
-    std::copy( points.points().begin(), points.points().end(),
-        std::back_inserter(vertices) );
-
     // Copy faces for output
     facets.reserve( reconstruct.number_of_facets() );
     for (const auto &facet : CGAL::make_range( reconstruct.facets_begin(),
@@ -316,7 +305,9 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	// OUTPUT PROCESSING
 	// -------------------------------------------------------------------------------------
   
-  std::size_t numVertices = vertices.size();
+  // The output vertices are written straight from the point set, whose
+  // garbage has been collected so that the facets index its points in order
+  std::size_t numVertices = points.size();
   std::size_t numFaces = facets.size();
 
   plhs[0] = mxCreateDoubleMatrix( numFaces, 3, mxREAL );
@@ -331,9 +322,10 @@ void mexFunction( int nlhs, mxArray *plhs[],
     for ( int j = 0; j < 3; j++ )
       facesOut[i+(j*numFaces)] = (double) (facets[i][j]+1.0);
 
-  for ( int i = 0; i < vertices.size(); i++ )
+  std::size_t i = 0;
+  for ( Point_set::const_iterator it = points.begin(); it != points.end(); it++, i++ )
     for ( int j = 0; j < dim; j++ )
-      vertexOut[i+(j*numVertices)] = vertices[i][j];
+      vertexOut[i+(j*numVertices)] = points.point(*it)[j];
 
   return;
 
@@ -30,6 +30,19 @@ template< class CVertex, class CEdge, class CFace, class CHalfEdge > // Added by
     ~CBaseEmbed(){};
 	/*! _embed the mesh */
     void _embed();
+	/*! _embed the mesh level by level from a central root face
+	 *
+	 *  The root face is the face with the smallest estimated BFS eccentricity,
+	 *  which keeps the number of levels small. The faces of one BFS level only
+	 *  depend on the vertices placed by the previous levels, they are embedded
+	 *  in parallel when built with OpenMP (-fopenmp). A vertex placed by several faces of a level goes to the mean
+	 *  of their positions, summed in BFS order, so the result does not depend
+	 *  on the number of threads. The positions differ by the residual curvature
+	 *  of the metric around the faces, which is what dominates the edge length
+	 *  distortion, not the depth of the BFS tree; the mean spreads it instead of
+	 *  keeping the position from a single face as _embed does.
+	 */
+	void _embed_wavefront();
 
   protected:
    
@@ -41,9 +54,28 @@ template< class CVertex, class CEdge, class CFace, class CHalfEdge > // Added by
 	 *
 	 */
 	virtual void _embed_face( CFace * head ) = 0;
+	/*! position of the vertex of a face which is not embedded yet, the mesh is not modified
+	 * \param head the face
+	 * \param C the vertex to be placed, NULL if all the vertices of head are embedded
+	 * \param uv the position of C
+	 * \return false if the position can not be computed
+	 */
+	virtual bool _place_face( CFace * head, CVertex * & C, CPoint2 & uv ) = 0;
 
 	/*! initialization */
 	void _initialize();
+	/*! index the vertices and faces and build the face adjacency */
+	void _index_mesh();
+	/*! BFS over the faces
+	 * \param root the first face
+	 * \param order the faces in BFS order, level by level
+	 * \param level the BFS level of each face, -1 if not reached
+	 */
+	void _face_bfs( int root, std::vector<int> & order, std::vector<int> & level );
+	/*! the face with the smallest eccentricity, estimated from a double sweep */
+	int _central_face();
+	/*! translate and scale the uv coordinates to the unit square */
+	void _normalize();
 
   protected:
 
@@ -52,6 +84,14 @@ template< class CVertex, class CEdge, class CFace, class CHalfEdge > // Added by
 
 	/*! queue of faces */
 	std::queue<CFace*> m_queue;
+
+	/*! vertices and faces, for the level by level embedding */
+	std::vector<CVertex*> m_verts;
+	std::vector<CFace*> m_faces;
+	/*! index of each vertex, addressed by vertex id */
+	std::vector<int> m_vertex_index;
+	/*! the three neighbors of each face, -1 on the boundary */
+	std::vector<int> m_face_adj;
   };
 
 
@@ -140,27 +180,232 @@ void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed()
 		_embed_face( head );
 	}
 
-	//normalize the uv coordinates
+	_normalize();
+};
+
+
+//Vertices and faces are indexed in iterator order, the ids are only used to go from
+//a pointer to its index
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_index_mesh()
+{
+	m_verts.clear();
+	int max_id = 0;
+	for( typename CRicciFlowMesh<CVertex,CEdge,CFace,CHalfEdge>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++ )
+	{
+		CVertex * v = *viter;
+		v->huv() = CPoint2( 0, 0 );
+		v->touched() = false;
+		m_verts.push_back( v );
+		if( v->id() > max_id ) max_id = v->id();
+	}
+	m_vertex_index.assign( max_id + 1, -1 );
+	for( size_t i = 0; i < m_verts.size(); i ++ )
+	{
+		m_vertex_index[ m_verts[i]->id() ] = (int) i;
+	}
+
+	m_faces.clear();
+	max_id = 0;
+	for( typename CRicciFlowMesh<CVertex,CEdge,CFace,CHalfEdge>::MeshFaceIterator fiter( m_pMesh ); !fiter.end(); fiter ++ )
+	{
+		CFace * f = *fiter;
+		f->touched() = false;
+		m_faces.push_back( f );
+		if( f->id() > max_id ) max_id = f->id();
+	}
+	std::vector<int> face_index( max_id + 1, -1 );
+	for( size_t i = 0; i < m_faces.size(); i ++ )
+	{
+		face_index[ m_faces[i]->id() ] = (int) i;
+	}
+
+	int nf = (int) m_faces.size();
+	m_face_adj.assign( 3 * nf, -1 );
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int f = 0; f < nf; f ++ )
+	{
+		CHalfEdge * he = m_pMesh->faceMostCcwHalfEdge( m_faces[f] );
+		for( int j = 0; j < 3; j ++ )
+		{
+			CHalfEdge * sh = m_pMesh->halfedgeSym( he );
+			if( sh != NULL ) m_face_adj[3*f+j] = face_index[ m_pMesh->halfedgeFace( sh )->id() ];
+			he = m_pMesh->faceNextCcwHalfEdge( he );
+		}
+	}
+};
+
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_face_bfs( int root, std::vector<int> & order, std::vector<int> & level )
+{
+	int nf = (int) m_faces.size();
+	level.assign( nf, -1 );
+	order.clear();
+	order.reserve( nf );
+
+	level[root] = 0;
+	order.push_back( root );
+	for( size_t i = 0; i < order.size(); i ++ )
+	{
+		int f = order[i];
+		for( int j = 0; j < 3; j ++ )
+		{
+			int df = m_face_adj[3*f+j];
+			if( df < 0 || level[df] >= 0 ) continue;
+			level[df] = level[f] + 1;
+			order.push_back( df );
+		}
+	}
+};
+
+//The last face of a BFS is one end b of a long path, the last face of a BFS from b is
+//the other end c. The eccentricity of f is at least max( d(b,f), d(c,f) ), the face
+//minimizing this bound lies in the middle of the path from b to c.
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+int CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_central_face()
+{
+	int nf = (int) m_faces.size();
+	std::vector<int> order, db, dc;
+
+	_face_bfs( nf - 1, order, db );
+	int b = order.back();
+	_face_bfs( b, order, db );
+	int c = order.back();
+	_face_bfs( c, order, dc );
+
+	int root = b;
+	int best = nf;
+	for( size_t i = 0; i < order.size(); i ++ )
+	{
+		int f = order[i];
+		int e = ( db[f] > dc[f] )? db[f] : dc[f];
+		if( e < best || ( e == best && f < root ) )
+		{
+			best = e;
+			root = f;
+		}
+	}
+	return root;
+};
+
+
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_wavefront()
+{
+	_index_mesh();
+
+	int root = _central_face();
+	std::vector<int> order, level;
+	_face_bfs( root, order, level );
+
+	_embed_first_face( m_faces[root] );
+	for( size_t i = 0; i < order.size(); i ++ )
+	{
+		m_faces[ order[i] ]->touched() = true;
+	}
+
+	int n = (int) order.size();
+
+	std::vector<int> vertex( n, -1 );		// index of the vertex placed by order[i]
+	std::vector<CPoint2> uv( n );
+	std::vector<char> placed( n, 0 );
+	std::vector<int> owner( m_verts.size(), -1 );	// position in order of the first face placing each vertex
+	std::vector<CPoint2> uv_sum( m_verts.size() );
+	std::vector<int> uv_count( m_verts.size(), 0 );
+
+	for( int begin = 1, end; begin < n; begin = end )
+	{
+		for( end = begin; end < n && level[ order[end] ] == level[ order[begin] ]; end ++ );
+
+		//faces of the level, each computes the position of its free vertex from the previous levels
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+		for( int i = begin; i < end; i ++ )
+		{
+			CVertex * C = NULL;
+			placed[i] = _place_face( m_faces[ order[i] ], C, uv[i] );
+			if( C != NULL ) vertex[i] = m_vertex_index[ C->id() ];
+		}
+
+		//sum the positions of each vertex in BFS order, the first face writes the mean
+		for( int i = begin; i < end; i ++ )
+		{
+			if( vertex[i] < 0 || !placed[i] ) continue;
+			if( owner[ vertex[i] ] < 0 ) owner[ vertex[i] ] = i;
+			uv_sum[ vertex[i] ] = uv_sum[ vertex[i] ] + uv[i];
+			uv_count[ vertex[i] ] ++;
+		}
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+		for( int i = begin; i < end; i ++ )
+		{
+			if( vertex[i] < 0 || owner[ vertex[i] ] != i ) continue;
+			CVertex * C = m_verts[ vertex[i] ];
+			C->huv() = uv_sum[ vertex[i] ] / uv_count[ vertex[i] ];
+			C->touched() = true;
+		}
+
+		//faces whose position failed, once more serially to report the error
+		for( int i = begin; i < end; i ++ )
+		{
+			if( vertex[i] >= 0 && !placed[i] ) _embed_face( m_faces[ order[i] ] );
+		}
+	}
+
+	_normalize();
+};
+
+//Translate and scale the uv coordinates to the unit square, the four extrema are
+//computed in a single parallel sweep
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_normalize()
+{
+	std::vector<CVertex*> verts;
+	verts.reserve( m_pMesh->numVertices() );
+	for( typename CRicciFlowMesh<CVertex,CEdge,CFace,CHalfEdge>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter++ )
+	{
+		verts.push_back( *viter );
+	}
+	int nv = (int) verts.size();
 
 	double u_min, u_max, v_min, v_max;
 	u_min = v_min = 1e30;
 	u_max = v_max = -1e30;
 
-
-	for( typename CRicciFlowMesh<CVertex,CEdge,CFace,CHalfEdge>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter++ )
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
 	{
-		CVertex * pV = *viter;
-		CPoint2 uv = pV->huv();
-		double u_param = uv[0];
-		double v_param = uv[1];
-		if( u_min>u_param )
-			u_min = u_param;
-		if( u_max<u_param )
-			u_max = u_param;
-		if( v_min>v_param )
-			v_min = v_param;
-		if( v_max<v_param )
-			v_max = v_param;
+		double lu_min, lu_max, lv_min, lv_max;
+		lu_min = lv_min = 1e30;
+		lu_max = lv_max = -1e30;
+
+#ifdef _OPENMP
+#pragma omp for nowait
+#endif
+		for( int i = 0; i < nv; i ++ )
+		{
+			CPoint2 & uv = verts[i]->huv();
+			if( lu_min>uv[0] ) lu_min = uv[0];
+			if( lu_max<uv[0] ) lu_max = uv[0];
+			if( lv_min>uv[1] ) lv_min = uv[1];
+			if( lv_max<uv[1] ) lv_max = uv[1];
+		}
+
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+		{
+			if( u_min>lu_min ) u_min = lu_min;
+			if( u_max<lu_max ) u_max = lu_max;
+			if( v_min>lv_min ) v_min = lv_min;
+			if( v_max<lv_max ) v_max = lv_max;
+		}
 	}
 
 	double range = ( u_max-u_min )>( v_max-v_min ) ? u_max-u_min : v_max-v_min;
@@ -168,10 +413,14 @@ void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed()
 	printf( "range = %lf\n", range );
 
 	if( range>1e-6 ) {
-		for( typename CRicciFlowMesh<CVertex,CEdge,CFace,CHalfEdge>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter++ )
+		double log_range = log( range );
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+		for( int i = 0; i < nv; i ++ )
 		{
-			CVertex * pV = *viter;
-			pV->u() -= log( range );
+			CVertex * pV = verts[i];
+			pV->u() -= log_range;
 			CPoint2 uv =  pV->huv();
 			double u_param = uv[0];
 			double v_param = uv[1];
@@ -185,4 +434,4 @@ void CBaseEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed()
 }
 
 
-#endif 
\ No newline at end of file
+#endif 
\ No newline at end of file
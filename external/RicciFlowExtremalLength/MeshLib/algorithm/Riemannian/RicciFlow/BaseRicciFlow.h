@@ -11,6 +11,9 @@
 
 #include <map>
 #include <vector>
+#include <algorithm>
+#include <cassert>
+#include <chrono>
 // #include <Eigen/Sparse> Modified by Dillon Cislo 2018/08/17
 #include "../../../../Eigen/Sparse"
 
@@ -30,6 +33,43 @@
 
 namespace MeshLib
 {
+/*! \brief CNewtonReport
+*
+*	Per-iteration statistics of the Newton solver, handed to the
+*	user callback. All times are wall-clock seconds.
+*/
+struct CNewtonReport
+{
+	/*! iteration number, starting from 0 */
+	int    iteration;
+	/*! maximal curvature error before the update */
+	double error;
+	/*! id of the vertex with the maximal curvature error */
+	int    max_error_vertex;
+	/*! accepted step length */
+	double step_length;
+	/*! number of step halvings taken by the line search */
+	int    backtracks;
+	/*! time spent filling the Hessian */
+	double assemble_time;
+	/*! time spent in the symbolic analysis (nonzero only when it was redone) */
+	double analyze_time;
+	/*! time spent in the numerical factorization */
+	double factorize_time;
+	/*! time spent in the triangular solves */
+	double solve_time;
+	/*! time spent evaluating trial steps in the line search */
+	double line_search_time;
+	/*! total time of the iteration */
+	double total_time;
+};
+
+/*! \brief Callback invoked once per Newton iteration
+ *  \param report statistics of the current iteration
+ *  \param pData  user data registered with the callback
+ */
+typedef void (*NewtonCallback)( const CNewtonReport & report, void * pData );
+
 /*! \brief BaseClass CBaseRicciFlow
 *
 *	Algorithm for computing general Ricci flow
@@ -50,6 +90,27 @@ template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
 	 */
 	virtual void _calculate_metric();
 
+	/*!	Convergence threshold on the maximal curvature error
+	 */
+	double & threshold() { return m_threshold; };
+	/*!	Whether Newton's method uses the backtracking line search
+	 */
+	bool & line_search() { return m_line_search; };
+	/*!	Register a callback receiving the per-iteration statistics
+	 *  of Newton's method. Pass NULL to restore the console output.
+	 *  \param callback the callback
+	 *  \param pData user data passed back to the callback
+	 */
+	void _set_callback( NewtonCallback callback, void * pData );
+	/*!	Warm start the flow from a previous solution
+	 *  \param u log radii, indexed by vertex idx
+	 */
+	void _set_u( const Eigen::VectorXd & u );
+	/*!	Copy out the current log radii
+	 *  \param u log radii, indexed by vertex idx
+	 */
+	void _get_u( Eigen::VectorXd & u );
+
 
   protected:
     /*!
@@ -60,6 +121,46 @@ template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
 	 *	boundary of the input mesh
 	 */
 	CBoundary<V,E,F,H>		  m_boundary;
+	/*!
+	 *	convergence threshold
+	 */
+	double m_threshold;
+	/*!
+	 *	use backtracking line search in Newton's method
+	 */
+	bool m_line_search;
+	/*!
+	 *	per-iteration callback and its user data
+	 */
+	NewtonCallback m_callback;
+	void         * m_callback_data;
+	/*!
+	 *	id of the vertex with the maximal curvature error,
+	 *	set by _calculate_curvature_error
+	 */
+	int m_max_error_vertex;
+	/*!
+	 *	Hessian matrix, its sparsity pattern is fixed by the mesh connectivity
+	 */
+	Eigen::SparseMatrix<double> m_hessian;
+	/*!
+	 *	Cholesky solver, the symbolic analysis is computed once
+	 */
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > m_solver;
+	/*!
+	 *	whether m_hessian and the symbolic analysis are ready
+	 */
+	bool m_pattern_ready;
+	/*!
+	 *	positions of the (v1,v2) and (v2,v1) entries of each edge
+	 *	in the value array of m_hessian, in MeshEdgeIterator order
+	 */
+	std::vector<int> m_edge_slots;
+	/*!
+	 *	position of the diagonal entry of each vertex in the value
+	 *	array of m_hessian, indexed by vertex idx
+	 */
+	std::vector<int> m_diag_slots;
 
   protected:
 	  /*!
@@ -118,13 +219,66 @@ template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
 	  * \param SparseMatrix
 	  */
 	 virtual void _calculate_Hessain( Eigen::SparseMatrix<double> & pMatrix );
+	 /*!
+	  *	build m_hessian, the edge/diagonal slot maps and the symbolic
+	  *	analysis of the solver from the mesh connectivity
+	  */
+	 void _analyze_Hessain();
+	 /*!
+	  *	refill the values of m_hessian in place from the current edge weights,
+	  *	has to be overridden together with _calculate_Hessain
+	  */
+	 virtual void _update_Hessain();
+	 /*!
+	  *	recompute edge lengths, corner angles and vertex curvatures
+	  *	after the log radii have changed
+	  */
+	 void _update_curvature();
+	 /*!
+	  *	report one Newton iteration, through the callback if one is set
+	  */
+	 void _report( const CNewtonReport & report );
+	 /*!
+	  *	target curvature minus curvature, indexed by vertex idx
+	  */
+	 void _get_curvature_difference( Eigen::VectorXd & b );
+
+	 template< class Flow > friend void _ricci_flow_newton( Flow & flow, double threshold, double step_length );
   };
 
+/*!
+ *	wall clock time in seconds
+ */
+inline double _ricci_flow_time()
+{
+	return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
+};
+
+/*!
+ *	position of entry (row,col) in the value array of a compressed
+ *	column-major sparse matrix, -1 if the entry is not stored
+ */
+inline int _hessian_slot( const Eigen::SparseMatrix<double> & M, int row, int col )
+{
+	const int * outer = M.outerIndexPtr();
+	const int * inner = M.innerIndexPtr();
+	const int * found = std::lower_bound( inner + outer[col], inner + outer[col+1], row );
+	if( found == inner + outer[col+1] || *found != row ) return -1;
+	return (int)( found - inner );
+};
+
 //Constructor
 //template<typename V, typename E, typename F, typename H>
 template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
 CBaseRicciFlow<V,E,F,H>::CBaseRicciFlow( CRicciFlowMesh<V,E,F,H> * pMesh ): m_pMesh( pMesh), m_boundary( pMesh )
 {
+  m_threshold = 5e-4;
+  m_line_search = true;
+  m_callback = NULL;
+  m_callback_data = NULL;
+  m_max_error_vertex = -1;
+  m_pattern_ready = false;
+
   int idx = 0;
   for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++ )
 	{
@@ -141,6 +295,38 @@ CBaseRicciFlow<V,E,F,H>::~CBaseRicciFlow( )
 {
 };
 
+//Register the per-iteration callback
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_set_callback( NewtonCallback callback, void * pData )
+{
+	m_callback = callback;
+	m_callback_data = pData;
+};
+
+//Warm start from previous log radii
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_set_u( const Eigen::VectorXd & u )
+{
+	assert( u.size() == m_pMesh->numVertices() );
+	for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++ )
+	{
+		V * v = *viter;
+		v->u() = u( v->idx() );
+	}
+};
+
+//Copy out the log radii
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_get_u( Eigen::VectorXd & u )
+{
+	u.resize( m_pMesh->numVertices() );
+	for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++ )
+	{
+		V * v = *viter;
+		u( v->idx() ) = v->u();
+	}
+};
+
 //Compute the edge length
 //template<typename V, typename E, typename F, typename H>
 template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
@@ -240,8 +426,8 @@ double CBaseRicciFlow<V,E,F,H>::_calculate_curvature_error()
 		vert = v;
 	   }
    }
-   printf("Vertex id is %d\n", vert->id() );
-   return max_error; 
+   m_max_error_vertex = ( vert != NULL )? vert->id() : -1;
+   return max_error;
 };
 
 //compute metric
@@ -252,10 +438,8 @@ void CBaseRicciFlow<V,E,F,H>::_calculate_metric()
 {
 
    _set_target_curvature();
-  //double error = 1e-6;
-  double threshold = 5e-4;
   double step_length = 1.0;
-   _Newton( threshold, step_length );     
+   _Newton( m_threshold, step_length );
 
 };
 
@@ -294,72 +478,218 @@ bool CBaseRicciFlow<V,E,F,H>::_flow( double error_threshold )
 };
 
 //Newton's method for optimizing entropy energy
-
-//template<typename V, typename E, typename F, typename H>
-template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
-void CBaseRicciFlow<V,E,F,H>::_Newton( double threshold, double step_length )
+//
+//The Hessian keeps the sparsity pattern of the mesh, so its symbolic
+//analysis is done once and only the numerical factorization is redone.
+//The step is damped by a backtracking line search on the entropy energy,
+//whose gradient is k - target_k; the energy change along the Newton
+//direction is integrated with the trapezoidal rule.
+//
+//Shared by CBaseRicciFlow and CFlatTangentialRicciFlow. Flow provides the
+//mesh, the Hessian and its solver, and indexes u, k and target_k by vertex
+//idx through _get_u, _set_u and _get_curvature_difference.
+
+template< class Flow >
+void _ricci_flow_newton( Flow & flow, double threshold, double step_length )
 {
-	int num = m_pMesh->numVertices();
+	int num = flow.m_pMesh->numVertices();
 
-	
-  	while( true )
+	double analyze_time = 0;
+	if( !flow.m_pattern_ready )
 	{
-		//the order of the following functions really matters
+		double t = _ricci_flow_time();
+		flow._analyze_Hessain();
+		analyze_time = _ricci_flow_time() - t;
+	}
 
- 		_calculate_edge_length();
-		_calculate_corner_angle();
-		_calculate_vertex_curvature();
-		_calculate_edge_weight();
+	//the order of the following functions really matters
+	flow._update_curvature();
+	flow._calculate_edge_weight();
 
-		double error =  _calculate_curvature_error();
-		printf("Newton's Method: Current error is %f\r\n", error );
+	Eigen::VectorXd b(num);
+	Eigen::VectorXd u(num);
+	Eigen::VectorXd trial(num);
 
-		if( error < threshold) break;
-	
+	for( int iter = 0; ; iter ++ )
+	{
+		CNewtonReport report;
+		report.iteration = iter;
+		report.step_length = 0;
+		report.backtracks = 0;
+		report.assemble_time = 0;
+		report.analyze_time = analyze_time;
+		report.factorize_time = 0;
+		report.solve_time = 0;
+		report.line_search_time = 0;
+		analyze_time = 0;
+
+		double start = _ricci_flow_time();
+
+		report.error = flow._calculate_curvature_error();
+		report.max_error_vertex = flow.m_max_error_vertex;
+
+		if( report.error < threshold )
+		{
+			report.total_time = _ricci_flow_time() - start;
+			flow._report( report );
+			break;
+		}
 
-		Eigen::SparseMatrix<double>  M( num, num );
-		M.setZero();
-		_calculate_Hessain( M );
+		flow._get_curvature_difference( b );
+		flow._get_u( u );
 
-		Eigen::VectorXd b(num);
+		double t = _ricci_flow_time();
+		flow._update_Hessain();
+		report.assemble_time = _ricci_flow_time() - t;
 
-		for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++  )
-		{
-		    V * v = *viter;
-			int idx = v->idx();
-			b(idx) = v->target_k() - v->k();
-		}
+		t = _ricci_flow_time();
+		flow.m_solver.factorize( flow.m_hessian );
+		report.factorize_time = _ricci_flow_time() - t;
 
-		//std::cout << M;
-		//Eigen::ConjugateGradient<Eigen::SparseMatrix<double>> solver;
-		Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > solver;
-		std::cerr << "Eigen Decomposition" << std::endl;
-		solver.compute(M);
-		std::cerr << "Eigen Decomposition Finished" << std::endl;
-	
-		if( solver.info() != Eigen::Success )
+		if( flow.m_solver.info() != Eigen::Success )
 		{
-			std::cerr << "Waring: Eigen decomposition failed" << std::endl;
+			std::cerr << "Warning: Eigen decomposition failed" << std::endl;
 		}
 
-		Eigen::VectorXd x = solver.solve(b);
-		if( solver.info() != Eigen::Success )
+		t = _ricci_flow_time();
+		Eigen::VectorXd x = flow.m_solver.solve(b);
+		report.solve_time = _ricci_flow_time() - t;
+
+		if( flow.m_solver.info() != Eigen::Success )
 		{
-			std::cerr << "Waring: Eigen decomposition failed" << std::endl;
+			std::cerr << "Warning: Eigen solve failed" << std::endl;
 		}
-		//std::cout << x.transpose();
 
-		_normalization( x, num );
+		flow._normalization( x, num );
+
+		//directional derivative of the entropy energy along x
+		double slope = -b.dot( x );
+		double step  = step_length;
 
-		for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++  )
+		t = _ricci_flow_time();
+		while( true )
 		{
-		    V * v = *viter;
-			int idx = v->idx();
-			v->u() += x(idx) * step_length;
+			trial = u + x * step;
+			flow._set_u( trial );
+			flow._update_curvature();
+
+			if( !flow.m_line_search || report.backtracks >= 30 ) break;
+
+			flow._get_curvature_difference( trial );
+			double dE = -step / 2.0 * ( b + trial ).dot( x );
+
+			//Armijo condition, also rejects NaN energies
+			if( dE <= 1e-4 * step * slope ) break;
+
+			step /= 2.0;
+			report.backtracks ++;
 		}
+		report.line_search_time = _ricci_flow_time() - t;
+		report.step_length = step;
 
-  }
+		flow._calculate_edge_weight();
+
+		report.total_time = _ricci_flow_time() - start;
+		flow._report( report );
+	}
+};
+
+//template<typename V, typename E, typename F, typename H>
+template< class V, class E, class F, class H > // Added by Dillon 2017/08/22
+void CBaseRicciFlow<V,E,F,H>::_Newton( double threshold, double step_length )
+{
+	_ricci_flow_newton( *this, threshold, step_length );
+};
+
+//Build the Hessian pattern and its symbolic factorization
+
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_analyze_Hessain()
+{
+	int num = m_pMesh->numVertices();
+
+	m_hessian.resize( num, num );
+	_calculate_Hessain( m_hessian );
+
+	m_edge_slots.clear();
+	m_edge_slots.reserve( 2 * m_pMesh->numEdges() );
+	for( typename CRicciFlowMesh<V,E,F,H>::MeshEdgeIterator eiter( m_pMesh ); !eiter.end(); eiter ++  )
+	{
+	  E * e = *eiter;
+	  V * v1 = m_pMesh->edgeVertex1( e );
+	  V * v2 = m_pMesh->edgeVertex2( e );
+
+	  m_edge_slots.push_back( _hessian_slot( m_hessian, v1->idx(), v2->idx() ) );
+	  m_edge_slots.push_back( _hessian_slot( m_hessian, v2->idx(), v1->idx() ) );
+	}
+
+	m_diag_slots.assign( num, -1 );
+	for( int i = 0; i < num; i ++ )
+	{
+		m_diag_slots[i] = _hessian_slot( m_hessian, i, i );
+	}
+
+	m_solver.analyzePattern( m_hessian );
+	m_pattern_ready = true;
+};
+
+//Refill the Hessian values in place, same entries as _calculate_Hessain
+
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_update_Hessain()
+{
+	double * val = m_hessian.valuePtr();
+	std::fill( val, val + m_hessian.nonZeros(), 0.0 );
+
+	int i = 0;
+	for( typename CRicciFlowMesh<V,E,F,H>::MeshEdgeIterator eiter( m_pMesh ); !eiter.end(); eiter ++  )
+	{
+	  E * e = *eiter;
+	  V * v1 = m_pMesh->edgeVertex1( e );
+	  V * v2 = m_pMesh->edgeVertex2( e );
+	  double w = e->weight();
 
+	  val[ m_edge_slots[i++] ] -= w;
+	  val[ m_edge_slots[i++] ] -= w;
+	  val[ m_diag_slots[ v1->idx() ] ] += w;
+	  val[ m_diag_slots[ v2->idx() ] ] += w;
+	}
+};
+
+//Update edge length, corner angle and vertex curvature from u
+
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_update_curvature()
+{
+	_calculate_edge_length();
+	_calculate_corner_angle();
+	_calculate_vertex_curvature();
+};
+
+//Target curvature minus curvature
+
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_get_curvature_difference( Eigen::VectorXd & b )
+{
+	b.resize( m_pMesh->numVertices() );
+	for( typename CRicciFlowMesh<V,E,F,H>::MeshVertexIterator viter( m_pMesh ); !viter.end(); viter ++ )
+	{
+		V * v = *viter;
+		b( v->idx() ) = v->target_k() - v->k();
+	}
+};
+
+//Report one Newton iteration
+
+template< class V, class E, class F, class H >
+void CBaseRicciFlow<V,E,F,H>::_report( const CNewtonReport & report )
+{
+	if( m_callback != NULL )
+	{
+		m_callback( report, m_callback_data );
+		return;
+	}
+	printf("Newton's Method: Current error is %f\r\n", report.error );
 };
 
 
@@ -40,6 +40,14 @@ class CEuclideanEmbed : public CBaseEmbed<CVertex, CEdge, CFace, CHalfEdge>
 	 *	embed one face
 	 */
 	void _embed_face( CFace * head );
+	/*!
+	 *	position of the free vertex of one face, see CBaseEmbed::_place_face
+	 */
+	bool _place_face( CFace * head, CVertex * & C, CPoint2 & uv );
+	/*!
+	 *	the free vertex C of a face and its two embedded vertices A, B in ccw order
+	 */
+	void _face_vertices( CFace * head, CVertex * & A, CVertex * & B, CVertex * & C );
 
   };
 
@@ -98,11 +106,9 @@ void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_first_face( CFace *
 };
 
 
-//vertex A, vertex B are known, vertex C is unknown
-
-//template<typename CVertex, typename CEdge, typename CFace, typename CHalfEdge>
-template< class CVertex, class CEdge, class CFace, class CHalfEdge > // Added by Dillon 2017/08/23
-void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
+//find the vertex C which is not embedded yet, A and B follow C in ccw order
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_face_vertices( CFace * head, CVertex * & A, CVertex * & B, CVertex * & C )
 {
   std::vector<CVertex*> av;
 
@@ -112,9 +118,9 @@ void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
 	  av.push_back( pV );
   }
 
-  CVertex * A = NULL;
-  CVertex * B = NULL;
-  CVertex * C = NULL;
+  A = NULL;
+  B = NULL;
+  C = NULL;
 
   for( int i = 0; i < 3; i ++ )
   {
@@ -124,8 +130,20 @@ void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
 	  B = av[(i+2)%3];
 	  break;
   }
-	
-  if( C == NULL ) return;
+}
+
+//vertex A, vertex B are known, vertex C is unknown, only reads the mesh so that
+//the faces of one BFS level can be placed in parallel
+
+template< class CVertex, class CEdge, class CFace, class CHalfEdge >
+bool CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_place_face( CFace * head, CVertex * & C, CPoint2 & uv )
+{
+  CVertex * A = NULL;
+  CVertex * B = NULL;
+
+  _face_vertices( head, A, B, C );
+
+  if( C == NULL ) return true;
 
 	//radius of the first circle
 	double r1 = this->m_pMesh->vertexEdge(A,C)->length();
@@ -136,20 +154,38 @@ void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
 	//center of the second circle
 	CPoint2 c2 = B->huv();
 
-	
 	CPoint2 i1;
 	CPoint2 i2;
 
 	int result =_circle_circle_intersection( CCircle(c1,r1), CCircle(c2,r2), i1, i2);
 
+	if( !result ) return false;
+
+	if( cross( c2-c1, i1 - c1 ) > 0 )
+		uv = i1;
+	else
+		uv = i2;
+
+	return true;
+}
+
+
+//vertex A, vertex B are known, vertex C is unknown
+
+//template<typename CVertex, typename CEdge, typename CFace, typename CHalfEdge>
+template< class CVertex, class CEdge, class CFace, class CHalfEdge > // Added by Dillon 2017/08/23
+void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
+{
+  CVertex * C = NULL;
+  CPoint2 uv;
+
+  bool result = _place_face( head, C, uv );
+
+  if( C == NULL ) return;
 
 	if( result )
 	{
-		if( cross( c2-c1, i1 - c1 ) > 0 )
-			C->huv()  = i1;
-		else
-			C->huv()  = i2;
-
+		C->huv()  = uv;
 		C->touched() = true;
 	}
 
@@ -159,6 +195,15 @@ void CEuclideanEmbed<CVertex,CEdge,CFace,CHalfEdge>::_embed_face( CFace * head )
 
 	if( ! result ) 
 	{
+		CVertex * A = NULL;
+		CVertex * B = NULL;
+		_face_vertices( head, A, B, C );
+
+		double r1 = this->m_pMesh->vertexEdge(A,C)->length();
+		double r2 = this->m_pMesh->vertexEdge(B,C)->length();
+		CPoint2 c1 = A->huv();
+		CPoint2 c2 = B->huv();
+
 		std::cout << "Circles do not intersect!\n";
 		printf("Face ID is %d\n", head->id() );
 		std::cout << "C = (" << C->huv()[0] << ", " << C->huv()[1] <<")\n"; 
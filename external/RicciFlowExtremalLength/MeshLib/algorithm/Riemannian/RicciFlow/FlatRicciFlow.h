@@ -0,0 +1,408 @@
+/*! \file FlatRicciFlow.h
+ *  \brief Tangential Ricci flow on the array based mesh
+ *  \date   10/15/2026
+ *
+ *	Tangential Ricci flow with structure of arrays storage. Every kernel
+ *	is a linear sweep over one element type, writing only to the element
+ *	it visits, so the loops vectorize and run in parallel with OpenMP.
+ */
+
+#ifndef _FLAT_RICCI_FLOW_H_
+#define _FLAT_RICCI_FLOW_H_
+
+#include <math.h>
+#include <stdio.h>
+#include <iostream>
+#include <vector>
+
+#include "../../../core/Mesh/FlatMesh.h"
+#include "./BaseRicciFlow.h"
+
+#ifndef PI
+#define PI 3.14159265358979323846
+#endif
+
+namespace MeshLib
+{
+/*! \brief Class CFlatTangentialRicciFlow
+*
+*	Tangential Ricci flow on a CFlatMesh, computing the same quantities as
+*	CTangentialRicciFlow. The vertex attributes are indexed by the flat mesh
+*	vertex index, which equals the idx() assigned by CBaseRicciFlow when the
+*	flat mesh is built from the same CRicciFlowMesh.
+*/
+class CFlatTangentialRicciFlow
+{
+public:
+	/*! \brief CFlatTangentialRicciFlow constructor
+	 *  \param pMesh the input mesh
+	 */
+	CFlatTangentialRicciFlow( CFlatMesh * pMesh );
+	/*! \brief CFlatTangentialRicciFlow destructor
+	 */
+	~CFlatTangentialRicciFlow(){};
+
+	/*!	vertex log radius */
+	std::vector<double> & u()        { return m_u; };
+	/*!	vertex curvature */
+	std::vector<double> & k()        { return m_k; };
+	/*!	vertex target curvature, has to be set by the caller */
+	std::vector<double> & target_k() { return m_target_k; };
+	/*!	edge length */
+	std::vector<double> & length()   { return m_length; };
+	/*!	edge weight */
+	std::vector<double> & weight()   { return m_weight; };
+	/*!	corner angle at the target of each halfedge */
+	std::vector<double> & angle()    { return m_angle; };
+
+	/*!	Convergence threshold on the maximal curvature error */
+	double & threshold()   { return m_threshold; };
+	/*!	Whether Newton's method uses the backtracking line search */
+	bool   & line_search() { return m_line_search; };
+	/*!	Register a callback receiving the per-iteration statistics */
+	void _set_callback( NewtonCallback callback, void * pData ) { m_callback = callback; m_callback_data = pData; };
+
+	/*!	Computing the metric with the target curvature set by the caller */
+	void _calculate_metric();
+
+	/*!	Calculate each edge length */
+	void _calculate_edge_length();
+	/*!	Calculate corner angle */
+	void _calculate_corner_angle();
+	/*!	Calculate vertex curvature */
+	void _calculate_vertex_curvature();
+	/*!	Calculate the edge weight */
+	void _calculate_edge_weight();
+	/*!	Calculate vertex curvature error */
+	double _calculate_curvature_error();
+	/*!	Refill the values of the Hessian from the current edge weights */
+	void _update_Hessain();
+	/*!
+	 *	Newton's method to optimize the entropy energy
+	 * \param threshold err bound
+	 * \param step_length step length
+	 */
+	void _Newton( double threshold, double step_length );
+
+protected:
+	/*! build the Hessian pattern, slot maps and symbolic analysis */
+	void _analyze_Hessain();
+	/*! length, angle and curvature from u */
+	void _update_curvature();
+	/*! copy out the log radii */
+	void _get_u( Eigen::VectorXd & u );
+	/*! set the log radii */
+	void _set_u( const Eigen::VectorXd & u );
+	/*! target curvature minus curvature */
+	void _get_curvature_difference( Eigen::VectorXd & b );
+	/*! remove the mean of the Newton step */
+	void _normalization( Eigen::VectorXd & x, int n );
+	/*! report one Newton iteration, through the callback if one is set */
+	void _report( const CNewtonReport & report );
+
+	template< class Flow > friend void _ricci_flow_newton( Flow & flow, double threshold, double step_length );
+
+protected:
+	/*! the input mesh */
+	CFlatMesh * m_pMesh;
+
+	/*! vertex attributes */
+	std::vector<double> m_u;
+	std::vector<double> m_k;
+	std::vector<double> m_target_k;
+	/*! edge attributes */
+	std::vector<double> m_length;
+	std::vector<double> m_weight;
+	/*! halfedge attributes */
+	std::vector<double> m_angle;
+	/*! face attributes, the tangential weight of each face */
+	std::vector<double> m_face_weight;
+
+	double         m_threshold;
+	bool           m_line_search;
+	NewtonCallback m_callback;
+	void         * m_callback_data;
+	int            m_max_error_vertex;
+
+	Eigen::SparseMatrix<double> m_hessian;
+	Eigen::SimplicialLDLT<Eigen::SparseMatrix<double> > m_solver;
+	bool             m_pattern_ready;
+	std::vector<int> m_edge_slots;
+	std::vector<int> m_diag_slots;
+};
+
+inline CFlatTangentialRicciFlow::CFlatTangentialRicciFlow( CFlatMesh * pMesh ) : m_pMesh( pMesh )
+{
+	m_u.assign( pMesh->numVertices(), 0.0 );
+	m_k.assign( pMesh->numVertices(), 0.0 );
+	m_target_k.assign( pMesh->numVertices(), 0.0 );
+	m_length.assign( pMesh->numEdges(), 0.0 );
+	m_weight.assign( pMesh->numEdges(), 0.0 );
+	m_angle.assign( pMesh->numHalfEdges(), 0.0 );
+	m_face_weight.assign( pMesh->numFaces(), 0.0 );
+
+	m_threshold = 1e-6;
+	m_line_search = true;
+	m_callback = NULL;
+	m_callback_data = NULL;
+	m_max_error_vertex = -1;
+	m_pattern_ready = false;
+};
+
+//Compute the edge length
+inline void CFlatTangentialRicciFlow::_calculate_edge_length()
+{
+	int ne = m_pMesh->numEdges();
+	const int * ev = m_pMesh->edgeVertices();
+	const double * u = &m_u[0];
+	double * l = &m_length[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int e = 0; e < ne; e ++ )
+	{
+		l[e] = exp( u[ ev[2*e] ] ) + exp( u[ ev[2*e+1] ] );
+	}
+};
+
+//Calculate corner angle, the angle at the target of halfedge h is opposite to prev(h)
+inline void CFlatTangentialRicciFlow::_calculate_corner_angle()
+{
+	int nf = m_pMesh->numFaces();
+	const int * he = m_pMesh->halfedgeEdges();
+	const double * l = &m_length[0];
+	double * angle = &m_angle[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int f = 0; f < nf; f ++ )
+	{
+		double l0 = l[ he[3*f]   ];
+		double l1 = l[ he[3*f+1] ];
+		double l2 = l[ he[3*f+2] ];
+
+		double c0 = ( l0*l0 + l1*l1 - l2*l2 ) / ( 2.0 * l0 * l1 );
+		double c1 = ( l1*l1 + l2*l2 - l0*l0 ) / ( 2.0 * l1 * l2 );
+		double c2 = ( l2*l2 + l0*l0 - l1*l1 ) / ( 2.0 * l2 * l0 );
+
+		angle[3*f]   = acos( c0 );
+		angle[3*f+1] = acos( c1 );
+		angle[3*f+2] = acos( c2 );
+	}
+};
+
+//Calculate vertex curvature
+inline void CFlatTangentialRicciFlow::_calculate_vertex_curvature()
+{
+	int nv = m_pMesh->numVertices();
+	const int * offset = m_pMesh->vertexInOffsets();
+	const int * in     = m_pMesh->vertexInHalfedges();
+	const double * angle = &m_angle[0];
+	double * k = &m_k[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int v = 0; v < nv; v ++ )
+	{
+		double kv = ( m_pMesh->isBoundary( v ) )? PI : PI * 2;
+		for( int i = offset[v]; i < offset[v+1]; i ++ )
+		{
+			kv -= angle[ in[i] ];
+		}
+		k[v] = kv;
+	}
+};
+
+//Calculate edge weight
+inline void CFlatTangentialRicciFlow::_calculate_edge_weight()
+{
+	int nf = m_pMesh->numFaces();
+	int ne = m_pMesh->numEdges();
+	const int * hv = m_pMesh->halfedgeTargets();
+	const int * eh = m_pMesh->edgeHalfedges();
+	const double * u = &m_u[0];
+	const double * l = &m_length[0];
+	double * fw = &m_face_weight[0];
+	double * w  = &m_weight[0];
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int f = 0; f < nf; f ++ )
+	{
+		double r0 = exp( u[ hv[3*f]   ] );
+		double r1 = exp( u[ hv[3*f+1] ] );
+		double r2 = exp( u[ hv[3*f+2] ] );
+		fw[f] = sqrt( r0 * r1 * r2 / ( r0 + r1 + r2 ) );
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int e = 0; e < ne; e ++ )
+	{
+		double s = fw[ eh[2*e] / 3 ];
+		if( eh[2*e+1] >= 0 ) s += fw[ eh[2*e+1] / 3 ];
+		w[e] = s / l[e];
+	}
+};
+
+//compute curvature error
+inline double CFlatTangentialRicciFlow::_calculate_curvature_error()
+{
+	int nv = m_pMesh->numVertices();
+	double max_error = -1;
+	m_max_error_vertex = -1;
+
+	for( int v = 0; v < nv; v ++ )
+	{
+		double err = fabs( m_target_k[v] - m_k[v] );
+		if( err > max_error )
+		{
+			max_error = err;
+			m_max_error_vertex = v;
+		}
+	}
+	if( m_max_error_vertex >= 0 )
+	{
+		m_max_error_vertex = m_pMesh->vertexId( m_max_error_vertex );
+	}
+	return max_error;
+};
+
+//length, angle and curvature from u
+inline void CFlatTangentialRicciFlow::_update_curvature()
+{
+	_calculate_edge_length();
+	_calculate_corner_angle();
+	_calculate_vertex_curvature();
+};
+
+//Build the Hessian pattern and its symbolic factorization
+inline void CFlatTangentialRicciFlow::_analyze_Hessain()
+{
+	int nv = m_pMesh->numVertices();
+	int ne = m_pMesh->numEdges();
+	const int * ev = m_pMesh->edgeVertices();
+
+	std::vector<Eigen::Triplet<double> > coefficients;
+	coefficients.reserve( 2 * ne + nv );
+	for( int e = 0; e < ne; e ++ )
+	{
+		coefficients.push_back( Eigen::Triplet<double>( ev[2*e], ev[2*e+1], 0.0 ) );
+		coefficients.push_back( Eigen::Triplet<double>( ev[2*e+1], ev[2*e], 0.0 ) );
+	}
+	for( int v = 0; v < nv; v ++ )
+	{
+		coefficients.push_back( Eigen::Triplet<double>( v, v, 0.0 ) );
+	}
+
+	m_hessian.resize( nv, nv );
+	m_hessian.setFromTriplets( coefficients.begin(), coefficients.end() );
+
+	m_edge_slots.resize( 2 * ne );
+	for( int e = 0; e < ne; e ++ )
+	{
+		m_edge_slots[2*e]   = _hessian_slot( m_hessian, ev[2*e], ev[2*e+1] );
+		m_edge_slots[2*e+1] = _hessian_slot( m_hessian, ev[2*e+1], ev[2*e] );
+	}
+	m_diag_slots.resize( nv );
+	for( int v = 0; v < nv; v ++ )
+	{
+		m_diag_slots[v] = _hessian_slot( m_hessian, v, v );
+	}
+
+	m_solver.analyzePattern( m_hessian );
+	m_pattern_ready = true;
+};
+
+//Refill the Hessian values in place
+inline void CFlatTangentialRicciFlow::_update_Hessain()
+{
+	if( !m_pattern_ready ) _analyze_Hessain();
+
+	int nv = m_pMesh->numVertices();
+	int ne = m_pMesh->numEdges();
+	const int * offset = m_pMesh->vertexEdgeOffsets();
+	const int * ve     = m_pMesh->vertexEdges();
+	const double * w = &m_weight[0];
+	double * val = m_hessian.valuePtr();
+
+	//every edge owns its two off-diagonal slots, every vertex its diagonal slot
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int e = 0; e < ne; e ++ )
+	{
+		val[ m_edge_slots[2*e]   ] = -w[e];
+		val[ m_edge_slots[2*e+1] ] = -w[e];
+	}
+
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for( int v = 0; v < nv; v ++ )
+	{
+		double d = 0;
+		for( int i = offset[v]; i < offset[v+1]; i ++ )
+		{
+			d += w[ ve[i] ];
+		}
+		val[ m_diag_slots[v] ] = d;
+	}
+};
+
+//copy out the log radii
+inline void CFlatTangentialRicciFlow::_get_u( Eigen::VectorXd & u )
+{
+	u = Eigen::Map<const Eigen::VectorXd>( &m_u[0], m_u.size() );
+};
+
+//set the log radii
+inline void CFlatTangentialRicciFlow::_set_u( const Eigen::VectorXd & u )
+{
+	Eigen::Map<Eigen::VectorXd>( &m_u[0], m_u.size() ) = u;
+};
+
+//target curvature minus curvature
+inline void CFlatTangentialRicciFlow::_get_curvature_difference( Eigen::VectorXd & b )
+{
+	int nv = m_pMesh->numVertices();
+	b.resize( nv );
+	for( int v = 0; v < nv; v ++ )
+	{
+		b(v) = m_target_k[v] - m_k[v];
+	}
+};
+
+//remove the mean of the Newton step
+inline void CFlatTangentialRicciFlow::_normalization( Eigen::VectorXd & x, int n )
+{
+	x.array() -= x.sum() / n;
+};
+
+//report one Newton iteration
+inline void CFlatTangentialRicciFlow::_report( const CNewtonReport & report )
+{
+	if( m_callback != NULL ) m_callback( report, m_callback_data );
+	else printf("Newton's Method: Current error is %f\r\n", report.error );
+};
+
+//Newton's method for optimizing entropy energy, see _ricci_flow_newton
+inline void CFlatTangentialRicciFlow::_Newton( double threshold, double step_length )
+{
+	_ricci_flow_newton( *this, threshold, step_length );
+};
+
+//compute metric
+inline void CFlatTangentialRicciFlow::_calculate_metric()
+{
+	_Newton( m_threshold, 1.0 );
+};
+
+}
+
+#endif // _FLAT_RICCI_FLOW_H_
@@ -11,6 +11,8 @@
 
 #include <map>
 #include <vector>
+#include <fstream>
+#include <cstring>
 
 #include "../../../core/Mesh/BaseMesh.h"
 #include "../../../core/Mesh/Vertex.h"
@@ -226,7 +228,7 @@ class CRicciFlowEdge : public  CEdge
 	double & inversive_distance() { return m_inversive_distance; };
 	/*! edge sharp
 	 */
-	bool sharp() { return m_sharp; };
+	bool & sharp() { return m_sharp; };
     /*!
 	 *	read sharp trait from the edge string
 	 */
@@ -343,6 +345,217 @@ public:
 public:
 	static unsigned long long m_input_traits;
 	static unsigned long long m_output_traits;
+
+	/*!
+	 *	Read a binary .mb file, see write_mb for the layout.
+	 *	\param input the input .mb file name
+	 *	\return false if the file can not be read
+	 */
+	bool read_mb( const char * input );
+	/*!
+	 *	Write a binary .mb file. The file is a 32 byte header
+	 *	{ "RFMB", version, #vertices, #faces, #sharp edges, flags, 0, 0 }
+	 *	of 32 bit integers, followed by the vertex points (3 doubles each),
+	 *	the vertex uv if flags & TRAIT_UV (2 doubles each), the vertex ids,
+	 *	the face ids, the face vertex indices (3 per face) and the sharp
+	 *	edge vertex indices (2 per edge), all 32 bit integers and zero based.
+	 *	\param output the output .mb file name
+	 *	\param with_uv whether to store the vertex uv
+	 */
+	void write_mb( const char * output, bool with_uv );
+};
+
+/*!
+ *	Header of the binary .mb mesh file
+ */
+struct CRicciFlowMeshHeader
+{
+	char magic[4];
+	int  version;
+	int  nVertices;
+	int  nFaces;
+	int  nSharpEdges;
+	int  flags;
+	int  reserved[2];
+};
+
+template< class V, class E, class F, class H >
+bool CRicciFlowMesh<V,E,F,H>::read_mb( const char * input )
+{
+	std::fstream is( input, std::fstream::in | std::fstream::binary );
+	if( is.fail() )
+	{
+		fprintf(stderr,"Error in opening file %s\n", input );
+		return false;
+	}
+
+	CRicciFlowMeshHeader header;
+	is.read( (char*) &header, sizeof( header ) );
+	if( is.fail() || strncmp( header.magic, "RFMB", 4 ) != 0 || header.version != 1 )
+	{
+		fprintf(stderr,"Error: %s is not a binary mesh file\n", input );
+		return false;
+	}
+
+	int nv = header.nVertices;
+	int nf = header.nFaces;
+	int ns = header.nSharpEdges;
+	bool with_uv = ( header.flags & TRAIT_UV ) != 0;
+
+	//check the counts against the file size before allocating anything
+	std::streamoff start = is.tellg();
+	is.seekg( 0, std::ios::end );
+	std::streamoff remaining = is.tellg() - start;
+	is.seekg( start );
+	if( nv < 0 || nf < 0 || ns < 0 || remaining !=
+		(std::streamoff) sizeof(double) * ( with_uv ? 5 : 3 ) * nv +
+		(std::streamoff) sizeof(int) * ( nv + 4 * (std::streamoff) nf + 2 * (std::streamoff) ns ) )
+	{
+		fprintf(stderr,"Error: %s is truncated or corrupt\n", input );
+		return false;
+	}
+
+	std::vector<double> points( 3 * nv );
+	std::vector<double> uv;
+	std::vector<int>    vids( nv ), fids( nf ), fv( 3 * nf ), sv( 2 * ns );
+
+	if( nv > 0 )
+	{
+		is.read( (char*) &points[0], sizeof(double) * points.size() );
+		if( with_uv )
+		{
+			uv.resize( 2 * nv );
+			is.read( (char*) &uv[0], sizeof(double) * uv.size() );
+		}
+		is.read( (char*) &vids[0], sizeof(int) * vids.size() );
+	}
+	if( nf > 0 )
+	{
+		is.read( (char*) &fids[0], sizeof(int) * fids.size() );
+		is.read( (char*) &fv[0], sizeof(int) * fv.size() );
+	}
+	if( ns > 0 )
+	{
+		is.read( (char*) &sv[0], sizeof(int) * sv.size() );
+	}
+	if( is.fail() )
+	{
+		fprintf(stderr,"Error: %s is truncated\n", input );
+		return false;
+	}
+
+	//the face and sharp edge vertex indices must be valid, the face vertices distinct
+	for( size_t i = 0; i < fv.size(); i ++ )
+	{
+		if( fv[i] < 0 || fv[i] >= nv || fv[i] == fv[ i - i % 3 + ( i + 1 ) % 3 ] )
+		{
+			fprintf(stderr,"Error: %s has an invalid face %d\n", input, (int) ( i / 3 ) );
+			return false;
+		}
+	}
+	for( size_t i = 0; i < sv.size(); i ++ )
+	{
+		if( sv[i] < 0 || sv[i] >= nv )
+		{
+			fprintf(stderr,"Error: %s has an invalid sharp edge %d\n", input, (int) ( i / 2 ) );
+			return false;
+		}
+	}
+
+	std::vector<V*> verts( nv );
+	for( int i = 0; i < nv; i ++ )
+	{
+		V * v = this->createVertex( vids[i] );
+		v->point() = CPoint( points[3*i], points[3*i+1], points[3*i+2] );
+		if( with_uv )
+		{
+			v->huv() = CPoint2( uv[2*i], uv[2*i+1] );
+		}
+		verts[i] = v;
+	}
+
+	for( int i = 0; i < nf; i ++ )
+	{
+		V * v[3] = { verts[ fv[3*i] ], verts[ fv[3*i+1] ], verts[ fv[3*i+2] ] };
+		this->createFace( v, fids[i] );
+	}
+
+	this->labelBoundary();
+
+	for( int i = 0; i < ns; i ++ )
+	{
+		E * e = this->vertexEdge( verts[ sv[2*i] ], verts[ sv[2*i+1] ] );
+		if( e != NULL ) e->sharp() = true;
+	}
+	return true;
+};
+
+template< class V, class E, class F, class H >
+void CRicciFlowMesh<V,E,F,H>::write_mb( const char * output, bool with_uv )
+{
+	std::fstream os( output, std::fstream::out | std::fstream::binary );
+	if( os.fail() )
+	{
+		fprintf(stderr,"Error is opening file %s\n", output );
+		return;
+	}
+
+	std::map<V*,int> index;
+	std::vector<double> points, uv;
+	std::vector<int>    vids, fids, fv, sv;
+
+	for( MeshVertexIterator viter( this ); !viter.end(); viter ++ )
+	{
+		V * v = *viter;
+		index[v] = (int) vids.size();
+		vids.push_back( v->id() );
+		for( int j = 0; j < 3; j ++ ) points.push_back( v->point()[j] );
+		if( with_uv )
+		{
+			uv.push_back( v->huv()[0] );
+			uv.push_back( v->huv()[1] );
+		}
+	}
+
+	for( MeshFaceIterator fiter( this ); !fiter.end(); fiter ++ )
+	{
+		F * f = *fiter;
+		fids.push_back( f->id() );
+		//createFace leaves the face halfedge at its last vertex, start after
+		//it so that read_mb rebuilds exactly the same halfedge structure
+		H * he = this->halfedgeNext( this->faceHalfedge( f ) );
+		for( int j = 0; j < 3; j ++ )
+		{
+			fv.push_back( index[ this->halfedgeTarget( he ) ] );
+			he = this->halfedgeNext( he );
+		}
+	}
+
+	for( MeshEdgeIterator eiter( this ); !eiter.end(); eiter ++ )
+	{
+		E * e = *eiter;
+		if( !e->sharp() ) continue;
+		sv.push_back( index[ this->edgeVertex1( e ) ] );
+		sv.push_back( index[ this->edgeVertex2( e ) ] );
+	}
+
+	CRicciFlowMeshHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.magic, "RFMB", 4 );
+	header.version     = 1;
+	header.nVertices   = (int) vids.size();
+	header.nFaces      = (int) fids.size();
+	header.nSharpEdges = (int) sv.size() / 2;
+	header.flags       = with_uv ? TRAIT_UV : 0;
+
+	os.write( (const char*) &header, sizeof( header ) );
+	if( !points.empty() ) os.write( (const char*) &points[0], sizeof(double) * points.size() );
+	if( !uv.empty() )     os.write( (const char*) &uv[0],     sizeof(double) * uv.size() );
+	if( !vids.empty() )   os.write( (const char*) &vids[0],   sizeof(int) * vids.size() );
+	if( !fids.empty() )   os.write( (const char*) &fids[0],   sizeof(int) * fids.size() );
+	if( !fv.empty() )     os.write( (const char*) &fv[0],     sizeof(int) * fv.size() );
+	if( !sv.empty() )     os.write( (const char*) &sv[0],     sizeof(int) * sv.size() );
+	os.close();
 };
 
 template< class V, class E, class F, class H >
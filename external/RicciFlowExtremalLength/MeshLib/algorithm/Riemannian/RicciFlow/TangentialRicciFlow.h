@@ -91,6 +91,7 @@ class CTangentialRicciFlow : public CBaseRicciFlow<V,E,F,H>
 template< class V, class E, class F, class H > // Added by Dillon 2017/08/23
 CTangentialRicciFlow<V,E,F,H>::CTangentialRicciFlow( CRicciFlowMesh<V,E,F,H> * pMesh ):CBaseRicciFlow<V,E,F,H>( pMesh)
 {
+	this->m_threshold = 1e-6;
 };
 
 //Compute the edge length
@@ -219,8 +220,7 @@ template< class V, class E, class F, class H > // Added by Dillon 2017/08/23
 void CTangentialRicciFlow<V,E,F,H>::_calculate_metric()
 {
 
-  double error = 1e-6;
-  //double error = 5e-4;
+  double error = this->m_threshold;
 
   this->_calculate_edge_length();
 
@@ -84,8 +84,9 @@ public:
 	/*!
 	Read an .m file.
 	\param input the input obj file name
+	\param traits whether to parse the traits from the element strings
 	*/
-	void read_m(  const char * input );
+	void read_m(  const char * input, bool traits = true );
 	/*!
 	Write an .m file.
 	\param output the output .m file name
@@ -103,6 +104,16 @@ public:
 	*/
 	void write_off( const char * output);
 
+	/*!
+	Build the mesh from vertex and face arrays, without any file IO.
+	Vertex i gets id i+1, face f gets id f+1.
+	\param points vertex coordinates, 3 per vertex
+	\param nv number of vertices
+	\param faces vertex indices, 3 per face, zero based
+	\param nf number of faces
+	*/
+	void read_arrays( const double * points, int nv, const int * faces, int nf );
+
 	//number of vertices, faces, edges
 	/*! number of vertices */
 	int  numVertices();
@@ -1329,7 +1340,7 @@ inline CHalfEdge * CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::vertexHalfedge( tVe
 	*/
 //template<typename CVertex, typename CEdge, typename CFace, typename CHalfEdge>
 template<class CVertex, class CEdge, class CFace, class CHalfEdge> // Added by Dillon 2017/08/22
-void CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::read_m( const char * input )
+void CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::read_m( const char * input, bool traits )
 {
 	std::fstream is( input, std::fstream::in );
 
@@ -1539,6 +1550,7 @@ void CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::read_m( const char * input )
 	}
 
 	//read in the traits
+	if( !traits ) return;
 
 	for( typename std::list<CVertex*>::iterator viter = m_verts.begin();  viter != m_verts.end() ; ++ viter )
 	{
@@ -2001,6 +2013,39 @@ void CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::read_off( const char * input )
 };
 
 
+/*!
+	Build the mesh from vertex and face arrays.
+	\param points vertex coordinates, 3 per vertex
+	\param nv number of vertices
+	\param faces vertex indices, 3 per face, zero based
+	\param nf number of faces
+	*/
+template<class CVertex, class CEdge, class CFace, class CHalfEdge>
+void CBaseMesh<CVertex,CEdge,CFace,CHalfEdge>::read_arrays( const double * points, int nv, const int * faces, int nf )
+{
+	std::vector<CVertex*> verts( nv );
+
+	for( int id = 0; id < nv; id ++ )
+	{
+		CVertex * v = createVertex( id + 1 );
+		v->point() = CPoint( points[3*id], points[3*id+1], points[3*id+2] );
+		verts[id] = v;
+	}
+
+	for( int id = 0; id < nf; id ++ )
+	{
+		CVertex * v[3];
+		for( int j = 0; j < 3; j ++ )
+		{
+			assert( faces[3*id+j] >= 0 && faces[3*id+j] < nv );
+			v[j] = verts[ faces[3*id+j] ];
+		}
+		createFace( v, id + 1 );
+	}
+
+	labelBoundary();
+};
+
 /*!
 	Label boundary edges, vertices
 */
@@ -0,0 +1,286 @@
+/*!
+*      \file FlatMesh.h
+*      \brief Array based halfedge mesh
+*
+*		Index based halfedge data structure for triangle meshes, used by
+*		the numerical kernels which sweep over all the mesh elements.
+*      \date 10/15/2026
+*
+*/
+
+#ifndef _MESHLIB_FLAT_MESH_H_
+#define _MESHLIB_FLAT_MESH_H_
+
+#include <assert.h>
+#include <algorithm>
+#include <list>
+#include <map>
+#include <vector>
+
+#include "./BaseMesh.h"
+
+namespace MeshLib{
+
+/*!
+* \brief CFlatMesh, array based triangle mesh
+*
+*  All the elements are addressed by integer indices and all the connectivity
+*  is stored in flat arrays. The halfedges of face f are 3f, 3f+1, 3f+2;
+*  halfedge 3f+i points to the i-th vertex of f and its previous halfedge is
+*  3f+(i+2)%3, the same convention as CBaseMesh::createFace. The incoming
+*  halfedges and the incident edges of each vertex are stored in compressed
+*  row format. Vertex indices follow the order of CBaseMesh::vertices().
+*
+*  The mesh carries no traits; algorithms keep their per element attributes
+*  in their own arrays indexed by the element indices.
+*/
+class CFlatMesh
+{
+public:
+	/*!
+	CFlatMesh constructor.
+	*/
+	CFlatMesh(){};
+	/*!
+	CFlatMesh destructor.
+	*/
+	~CFlatMesh(){};
+
+	/*!
+	Build the mesh from vertex and face arrays.
+	\param points vertex coordinates, 3 per vertex, may be NULL
+	\param nv number of vertices
+	\param faces vertex indices, 3 per face, zero based
+	\param nf number of faces
+	*/
+	void _from_arrays( const double * points, int nv, const int * faces, int nf );
+
+	/*!
+	Build the mesh from a pointer based mesh.
+	\param pMesh the input mesh, must be a triangle mesh
+	*/
+	template<class CVertex, class CEdge, class CFace, class CHalfEdge>
+	void _from_mesh( CBaseMesh<CVertex,CEdge,CFace,CHalfEdge> * pMesh );
+
+	/*! number of vertices */
+	int numVertices()  { return (int) m_vertex_id.size(); };
+	/*! number of edges */
+	int numEdges()     { return (int) m_edge_vertex.size() / 2; };
+	/*! number of faces */
+	int numFaces()     { return (int) m_halfedge_vertex.size() / 3; };
+	/*! number of halfedges */
+	int numHalfEdges() { return (int) m_halfedge_vertex.size(); };
+
+	/*! target vertex of halfedge h */
+	int halfedgeTarget( int h ) { return m_halfedge_vertex[h]; };
+	/*! source vertex of halfedge h */
+	int halfedgeSource( int h ) { return m_halfedge_vertex[ halfedgePrev(h) ]; };
+	/*! next halfedge of h in its face */
+	int halfedgeNext( int h )   { return ( h % 3 == 2 )? h - 2 : h + 1; };
+	/*! previous halfedge of h in its face */
+	int halfedgePrev( int h )   { return ( h % 3 == 0 )? h + 2 : h - 1; };
+	/*! dual halfedge of h, -1 if h is on the boundary */
+	int halfedgeSym( int h )    { return m_halfedge_sym[h]; };
+	/*! edge of halfedge h */
+	int halfedgeEdge( int h )   { return m_halfedge_edge[h]; };
+	/*! face of halfedge h */
+	int halfedgeFace( int h )   { return h / 3; };
+
+	/*! first vertex of edge e, the one with the smaller index */
+	int edgeVertex1( int e ) { return m_edge_vertex[2*e]; };
+	/*! second vertex of edge e */
+	int edgeVertex2( int e ) { return m_edge_vertex[2*e+1]; };
+	/*! halfedge i of edge e, halfedge 1 is -1 on the boundary */
+	int edgeHalfedge( int e, int i ) { return m_edge_halfedge[2*e+i]; };
+
+	/*! whether vertex v is on the boundary */
+	bool isBoundary( int v ) { return m_vertex_boundary[v] != 0; };
+	/*! id of vertex v in the source mesh or file */
+	int  vertexId( int v )   { return m_vertex_id[v]; };
+	/*! coordinates of vertex v */
+	const double * vertexPoint( int v ) { return &m_vertex_point[3*v]; };
+
+	/*! incoming halfedges of v are vertexInHalfedges()[ vertexInOffsets()[v] .. vertexInOffsets()[v+1] ) */
+	const int * vertexInOffsets()    { return &m_vertex_in_offset[0]; };
+	const int * vertexInHalfedges()  { return &m_vertex_in_halfedge[0]; };
+	/*! incident edges of v are vertexEdges()[ vertexEdgeOffsets()[v] .. vertexEdgeOffsets()[v+1] ) */
+	const int * vertexEdgeOffsets()  { return &m_vertex_edge_offset[0]; };
+	const int * vertexEdges()        { return &m_vertex_edge[0]; };
+	/*! target vertices of all halfedges, i.e. the face vertex array */
+	const int * halfedgeTargets()    { return &m_halfedge_vertex[0]; };
+	/*! edges of all halfedges */
+	const int * halfedgeEdges()      { return &m_halfedge_edge[0]; };
+	/*! end vertices of all edges, 2 per edge */
+	const int * edgeVertices()       { return &m_edge_vertex[0]; };
+	/*! halfedges of all edges, 2 per edge */
+	const int * edgeHalfedges()      { return &m_edge_halfedge[0]; };
+
+protected:
+	/*! vertex coordinates, 3 per vertex */
+	std::vector<double> m_vertex_point;
+	/*! vertex ids */
+	std::vector<int>    m_vertex_id;
+	/*! boundary flags of the vertices */
+	std::vector<char>   m_vertex_boundary;
+	/*! incoming halfedges of each vertex */
+	std::vector<int>    m_vertex_in_offset;
+	std::vector<int>    m_vertex_in_halfedge;
+	/*! incident edges of each vertex */
+	std::vector<int>    m_vertex_edge_offset;
+	std::vector<int>    m_vertex_edge;
+	/*! target vertex of each halfedge */
+	std::vector<int>    m_halfedge_vertex;
+	/*! dual halfedge of each halfedge */
+	std::vector<int>    m_halfedge_sym;
+	/*! edge of each halfedge */
+	std::vector<int>    m_halfedge_edge;
+	/*! end vertices of each edge */
+	std::vector<int>    m_edge_vertex;
+	/*! halfedges of each edge */
+	std::vector<int>    m_edge_halfedge;
+};
+
+/*!
+	Build the mesh from vertex and face arrays.
+	Vertex ids are set to the one based vertex indices.
+*/
+inline void CFlatMesh::_from_arrays( const double * points, int nv, const int * faces, int nf )
+{
+	m_vertex_point.assign( 3 * nv, 0.0 );
+	if( points != NULL )
+	{
+		std::copy( points, points + 3 * nv, m_vertex_point.begin() );
+	}
+	m_vertex_id.resize( nv );
+	for( int v = 0; v < nv; v ++ ) m_vertex_id[v] = v + 1;
+	m_halfedge_vertex.assign( faces, faces + 3 * nf );
+
+	int nh = 3 * nf;
+
+	//pair the halfedges by sorting them on their undirected edge key
+	std::vector< std::pair<long long,int> > keys( nh );
+	for( int h = 0; h < nh; h ++ )
+	{
+		int s = m_halfedge_vertex[ halfedgePrev(h) ];
+		int t = m_halfedge_vertex[h];
+		assert( s != t && s >= 0 && s < nv && t >= 0 && t < nv );
+		long long a = std::min( s, t );
+		long long b = std::max( s, t );
+		keys[h] = std::make_pair( a * nv + b, h );
+	}
+	std::sort( keys.begin(), keys.end() );
+
+	m_halfedge_sym.assign( nh, -1 );
+	m_halfedge_edge.assign( nh, -1 );
+	m_edge_vertex.clear();
+	m_edge_halfedge.clear();
+	m_vertex_boundary.assign( nv, 0 );
+
+	for( int i = 0; i < nh; )
+	{
+		int j = i + 1;
+		while( j < nh && keys[j].first == keys[i].first ) j ++;
+		//non-manifold edge
+		assert( j - i <= 2 );
+
+		int e  = (int) m_edge_vertex.size() / 2;
+		int h0 = keys[i].second;
+		int h1 = ( j - i == 2 )? keys[i+1].second : -1;
+
+		m_halfedge_edge[h0] = e;
+		m_edge_vertex.push_back( (int)( keys[i].first / nv ) );
+		m_edge_vertex.push_back( (int)( keys[i].first % nv ) );
+		m_edge_halfedge.push_back( h0 );
+		m_edge_halfedge.push_back( h1 );
+
+		if( h1 >= 0 )
+		{
+			assert( m_halfedge_vertex[h0] == halfedgeSource(h1) );
+			m_halfedge_edge[h1] = e;
+			m_halfedge_sym[h0] = h1;
+			m_halfedge_sym[h1] = h0;
+		}
+		else
+		{
+			m_vertex_boundary[ m_halfedge_vertex[h0] ] = 1;
+			m_vertex_boundary[ halfedgeSource(h0) ]    = 1;
+		}
+		i = j;
+	}
+
+	int ne = numEdges();
+
+	//incoming halfedges of each vertex
+	m_vertex_in_offset.assign( nv + 1, 0 );
+	for( int h = 0; h < nh; h ++ ) m_vertex_in_offset[ m_halfedge_vertex[h] + 1 ] ++;
+	for( int v = 0; v < nv; v ++ ) m_vertex_in_offset[v+1] += m_vertex_in_offset[v];
+	m_vertex_in_halfedge.resize( nh );
+	std::vector<int> pos( m_vertex_in_offset.begin(), m_vertex_in_offset.end() - 1 );
+	for( int h = 0; h < nh; h ++ ) m_vertex_in_halfedge[ pos[ m_halfedge_vertex[h] ] ++ ] = h;
+
+	//incident edges of each vertex
+	m_vertex_edge_offset.assign( nv + 1, 0 );
+	for( int e = 0; e < ne; e ++ )
+	{
+		m_vertex_edge_offset[ m_edge_vertex[2*e]   + 1 ] ++;
+		m_vertex_edge_offset[ m_edge_vertex[2*e+1] + 1 ] ++;
+	}
+	for( int v = 0; v < nv; v ++ ) m_vertex_edge_offset[v+1] += m_vertex_edge_offset[v];
+	m_vertex_edge.resize( 2 * ne );
+	pos.assign( m_vertex_edge_offset.begin(), m_vertex_edge_offset.end() - 1 );
+	for( int e = 0; e < ne; e ++ )
+	{
+		m_vertex_edge[ pos[ m_edge_vertex[2*e]   ] ++ ] = e;
+		m_vertex_edge[ pos[ m_edge_vertex[2*e+1] ] ++ ] = e;
+	}
+};
+
+/*!
+	Build the mesh from a pointer based mesh. The i-th vertex of the
+	flat mesh is the i-th vertex of pMesh->vertices(), and the f-th face
+	is the f-th face of pMesh->faces(), its vertices listed in the order
+	of CBaseMesh::write_m.
+*/
+template<class CVertex, class CEdge, class CFace, class CHalfEdge>
+void CFlatMesh::_from_mesh( CBaseMesh<CVertex,CEdge,CFace,CHalfEdge> * pMesh )
+{
+	std::list<CVertex*> & verts = pMesh->vertices();
+	std::list<CFace*>   & faces = pMesh->faces();
+
+	int nv = (int) verts.size();
+	int nf = (int) faces.size();
+
+	std::vector<double> points( 3 * nv );
+	std::vector<int>    ids( nv );
+	std::map<CVertex*,int> index;
+
+	int v = 0;
+	for( typename std::list<CVertex*>::iterator viter = verts.begin(); viter != verts.end(); viter ++, v ++ )
+	{
+		CVertex * pV = *viter;
+		index[pV] = v;
+		ids[v] = pV->id();
+		for( int i = 0; i < 3; i ++ ) points[3*v+i] = pV->point()[i];
+	}
+
+	std::vector<int> fv( 3 * nf );
+	int f = 0;
+	for( typename std::list<CFace*>::iterator fiter = faces.begin(); fiter != faces.end(); fiter ++, f ++ )
+	{
+		CFace * pF = *fiter;
+		CHalfEdge * he = pMesh->faceHalfedge( pF );
+		for( int i = 0; i < 3; i ++ )
+		{
+			fv[3*f+i] = index[ pMesh->halfedgeTarget( he ) ];
+			he = pMesh->halfedgeNext( he );
+		}
+		assert( he == pMesh->faceHalfedge( pF ) );
+	}
+
+	_from_arrays( &points[0], nv, &fv[0], nf );
+	m_vertex_id = ids;
+};
+
+}//name space MeshLib
+
+#endif //_MESHLIB_FLAT_MESH_H_
@@ -0,0 +1,189 @@
+/*!
+*      \file bench_flat_mesh.cpp
+*      \brief Benchmark of the Ricci flow kernels on CRFMesh and CFlatMesh
+*      \date 10/15/2026
+*
+*		Measures the per-iteration cost of the Ricci flow kernels (edge length,
+*		corner angle, vertex curvature, edge weight, Hessian fill) on the
+*		pointer based mesh and on the array based mesh, then runs Newton's
+*		method on both and compares the resulting log radii. Finally embeds
+*		the flat metric with the serial BFS walk and with the level by level
+*		embedding, and compares their edge length distortion.
+*
+*		g++ -O3 -fopenmp -I.. -o bench_flat_mesh bench_flat_mesh.cpp
+*		./bench_flat_mesh Alex.remesh.m mesh3d_T001.m
+*/
+
+#include <iostream>
+
+#include "../MeshLib/algorithm/Structure/Structure.h"
+#include "../MeshLib/algorithm/Riemannian/RicciFlow/TangentialRicciExtremalLength.h"
+#include "../MeshLib/algorithm/Riemannian/RicciFlow/FlatRicciFlow.h"
+#include "../MeshLib/algorithm/Riemannian/RicciFlow/EuclideanEmbed.h"
+
+using namespace MeshLib;
+
+unsigned int CRicciFlowVertex::traits = 0;
+
+typedef CTangentialRicciFlowExtremalLength<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> CRFExtremalLength;
+typedef CTangentialRicciFlow<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> CRFTangential;
+
+/*!
+ *	Exposes the protected kernels of the pointer based flow
+ */
+class CBenchRicciFlow : public CRFExtremalLength
+{
+public:
+	CBenchRicciFlow( CRFMesh * pMesh ) : CRFExtremalLength( pMesh ) {};
+
+	/*! corner targets if the mesh has sharp corners, circular boundaries otherwise */
+	void _set_target()
+	{
+		this->_calculate_edge_length();
+		int corners = 0;
+		for( CRFMesh::MeshVertexIterator viter( this->m_pMesh ); !viter.end(); viter ++ )
+		{
+			if( (*viter)->valence() > 2 ) corners ++;
+		}
+		if( corners > 0 ) CRFExtremalLength::_set_target_curvature();
+		else CRFTangential::_set_target_curvature();
+	};
+	void _geometry()  { this->_update_curvature(); };
+	void _weight()    { this->_calculate_edge_weight(); };
+	void _hessian()
+	{
+		if( !this->m_pattern_ready ) this->_analyze_Hessain();
+		this->_update_Hessain();
+	};
+	void _solve()     { this->_Newton( this->m_threshold, 1.0 ); };
+};
+
+static void _count_iterations( const CNewtonReport & report, void * pData )
+{
+	*(int*) pData = report.iteration;
+}
+
+/*!
+ *	Spread of |uv(e)| / length(e) over the edges, relative to its mean
+ */
+double _embed_distortion( CRFMesh & mesh )
+{
+	double lo = 1e30, hi = 0, sum = 0;
+	int n = 0;
+	for( CRFMesh::MeshEdgeIterator eiter( &mesh ); !eiter.end(); eiter ++ )
+	{
+		CRicciFlowEdge * e = *eiter;
+		CRicciFlowVertex * v1 = mesh.edgeVertex1( e );
+		CRicciFlowVertex * v2 = mesh.edgeVertex2( e );
+		double r = ( v1->huv() - v2->huv() ).norm() / e->length();
+		lo = std::min( lo, r );
+		hi = std::max( hi, r );
+		sum += r;
+		n ++;
+	}
+	return ( hi - lo ) / ( sum / n );
+}
+
+void _bench( const char * input, int rounds )
+{
+	CRFMesh mesh;
+	double t = _ricci_flow_time();
+	mesh.read_m( input );
+	double read_time = _ricci_flow_time() - t;
+
+	CBenchRicciFlow flow( &mesh );
+	flow._set_target();
+
+	t = _ricci_flow_time();
+	CFlatMesh flat;
+	flat._from_mesh( &mesh );
+	double build_time = _ricci_flow_time() - t;
+
+	CFlatTangentialRicciFlow flat_flow( &flat );
+	int i = 0;
+	for( CRFMesh::MeshVertexIterator viter( &mesh ); !viter.end(); viter ++, i ++ )
+	{
+		flat_flow.target_k()[i] = (*viter)->target_k();
+	}
+
+	printf( "%s: %d vertices, %d faces, read %.3fs, flat build %.3fs\n", input,
+		flat.numVertices(), flat.numFaces(), read_time, build_time );
+
+	double mesh_time[3]  = { 0, 0, 0 };
+	double flat_time[3] = { 0, 0, 0 };
+
+	flow._hessian();
+	flat_flow._calculate_edge_length();
+	flat_flow._calculate_corner_angle();
+	flat_flow._calculate_vertex_curvature();
+	flat_flow._calculate_edge_weight();
+	flat_flow._update_Hessain();
+
+	for( int r = 0; r < rounds; r ++ )
+	{
+		t = _ricci_flow_time(); flow._geometry(); mesh_time[0] += _ricci_flow_time() - t;
+		t = _ricci_flow_time(); flow._weight();   mesh_time[1] += _ricci_flow_time() - t;
+		t = _ricci_flow_time(); flow._hessian();  mesh_time[2] += _ricci_flow_time() - t;
+
+		t = _ricci_flow_time();
+		flat_flow._calculate_edge_length();
+		flat_flow._calculate_corner_angle();
+		flat_flow._calculate_vertex_curvature();
+		flat_time[0] += _ricci_flow_time() - t;
+		t = _ricci_flow_time(); flat_flow._calculate_edge_weight(); flat_time[1] += _ricci_flow_time() - t;
+		t = _ricci_flow_time(); flat_flow._update_Hessain();        flat_time[2] += _ricci_flow_time() - t;
+	}
+
+	const char * names[3] = { "length+angle+curvature", "edge weight", "Hessian fill" };
+	double mesh_total = 0, flat_total = 0;
+	for( int k = 0; k < 3; k ++ )
+	{
+		printf( "  %-24s mesh %8.3f ms  flat %8.3f ms  x%.1f\n", names[k],
+			1e3 * mesh_time[k] / rounds, 1e3 * flat_time[k] / rounds, mesh_time[k] / flat_time[k] );
+		mesh_total += mesh_time[k];
+		flat_total += flat_time[k];
+	}
+	printf( "  %-24s mesh %8.3f ms  flat %8.3f ms  x%.1f\n", "per iteration",
+		1e3 * mesh_total / rounds, 1e3 * flat_total / rounds, mesh_total / flat_total );
+
+	//full Newton solve from u = 0
+	int mesh_iter = 0, flat_iter = 0;
+	flow._set_callback( _count_iterations, &mesh_iter );
+	flat_flow._set_callback( _count_iterations, &flat_iter );
+
+	t = _ricci_flow_time(); flow._solve(); double mesh_newton = _ricci_flow_time() - t;
+	t = _ricci_flow_time(); flat_flow._calculate_metric(); double flat_newton = _ricci_flow_time() - t;
+
+	Eigen::VectorXd u;
+	flow._get_u( u );
+	double diff = 0;
+	for( int v = 0; v < flat.numVertices(); v ++ )
+	{
+		diff = std::max( diff, fabs( u(v) - flat_flow.u()[v] ) );
+	}
+	printf( "  %-24s mesh %8.3f s (%d it)  flat %8.3f s (%d it)  max |du| %g\n", "Newton",
+		mesh_newton, mesh_iter, flat_newton, flat_iter, diff );
+
+	//embedding of the metric found on the pointer based mesh
+	CRFEmbed embed( &mesh );
+	t = _ricci_flow_time(); embed._embed(); double serial_time = _ricci_flow_time() - t;
+	double serial_error = _embed_distortion( mesh );
+	t = _ricci_flow_time(); embed._embed_wavefront(); double wavefront_time = _ricci_flow_time() - t;
+	double wavefront_error = _embed_distortion( mesh );
+	printf( "  %-24s serial %8.3f ms (distortion %g)  wavefront %8.3f ms (distortion %g)\n", "embed",
+		1e3 * serial_time, serial_error, 1e3 * wavefront_time, wavefront_error );
+}
+
+int main( int argc, char * argv[] )
+{
+	if( argc < 2 )
+	{
+		std::cout << "Usage: bench_flat_mesh mesh.m [mesh.m ...]" << std::endl;
+		return 0;
+	}
+	for( int i = 1; i < argc; i ++ )
+	{
+		_bench( argv[i], 20 );
+	}
+	return 0;
+}
@@ -0,0 +1,11 @@
+function compile_ricci_flow
+
+mex -v -O ricci_flow.cpp ...
+    CXXFLAGS="$CXXFLAGS -fopenmp -fPIC" ...
+    LDFLAGS="$LDFLAGS -fopenmp"
+
+mex -v -O ricci_flow_extremal_length.cpp ...
+    CXXFLAGS="$CXXFLAGS -fopenmp -fPIC" ...
+    LDFLAGS="$LDFLAGS -fopenmp"
+
+end
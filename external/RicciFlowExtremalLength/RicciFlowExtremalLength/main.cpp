@@ -21,45 +21,127 @@ using namespace MeshLib;
 
 unsigned int CRicciFlowVertex::traits = 0;
 
+/******************************************************************************************************************************
+*
+*	Mesh IO, .mb files are binary, everything else is read as .m
+*
+*******************************************************************************************************************************/
+
+bool _is_binary( const char * name )
+{
+	size_t n = strlen( name );
+	return n > 3 && strcmp( name + n - 3, ".mb" ) == 0;
+}
+
+//traits: whether the .m vertex/edge/face strings need to be parsed
+bool _read_mesh( CRFMesh & mesh, const char * name, bool traits )
+{
+	if( _is_binary( name ) ) return mesh.read_mb( name );
+	mesh.read_m( name, traits );
+	return true;
+}
+
+//whether the mesh file has vertex uv, for .m the uv is parsed from the vertex strings into huv
+bool _read_uv( CRFMesh & mesh, const char * name )
+{
+	if( _is_binary( name ) )
+	{
+		CRicciFlowMeshHeader header;
+		std::ifstream is( name, std::ios::binary );
+		is.read( (char*) &header, sizeof( header ) );
+		return !is.fail() && ( header.flags & TRAIT_UV ) != 0;
+	}
+
+	bool with_uv = false;
+	for( CRFMesh::MeshVertexIterator viter( &mesh ); !viter.end(); viter ++ )
+	{
+		CRicciFlowVertex * v = *viter;
+		CParser parser( v->string() );
+		for( std::list<CToken*>::iterator iter = parser.tokens().begin(); iter != parser.tokens().end(); ++ iter )
+		{
+			double uv[2];
+			if( (*iter)->m_key == "uv" && sscanf( (*iter)->m_value.c_str(), "(%lf %lf)", &uv[0], &uv[1] ) == 2 )
+			{
+				v->huv() = CPoint2( uv[0], uv[1] );
+				with_uv = true;
+			}
+		}
+	}
+	return with_uv;
+}
+
+void _write_mesh( CRFMesh & mesh, const char * name )
+{
+	if( _is_binary( name ) ) mesh.write_mb( name, ( CRicciFlowVertex::traits & TRAIT_UV ) != 0 );
+	else mesh.write_m( name );
+}
+
+//wavefront: embed level by level from a central face instead of the serial walk
+void _embed_mesh( CRFMesh & mesh, bool wavefront )
+{
+	CRFEmbed embed( &mesh );
+	if( wavefront ) embed._embed_wavefront();
+	else embed._embed();
+}
+
 /******************************************************************************************************************************
 *
 *	Extremal Length
 *
 *******************************************************************************************************************************/
 
-//-tangent_ricci_extremal_length sophie.remesh.m sophie.uv.m
-void _tangent_ricci_extremal_length( const char * _input_mesh, const char * _mesh_with_uv )
+//-tangent_ricci_extremal_length sophie.remesh.m sophie.uv.m [-wavefront]
+void _tangent_ricci_extremal_length( const char * _input_mesh, const char * _mesh_with_uv, bool wavefront )
 {
 	CRicciFlowVertex::traits = CRicciFlowVertex::traits | TRAIT_UV;
 
 	CRFMesh mesh;
-	mesh.read_m( _input_mesh );
+	if( !_read_mesh( mesh, _input_mesh, true ) ) return;
 	//mesh.read_obj( _input_mesh );
 
 	CTangentialRicciFlowExtremalLength<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
 	mapper._calculate_metric();
 
-	CRFEmbed embed( &mesh );
-	embed._embed();
-	mesh.write_m( _mesh_with_uv );
+	_embed_mesh( mesh, wavefront );
+	_write_mesh( mesh, _mesh_with_uv );
 }
 
-// -tangent_ricci
-void _tangent_ricci( const char * _input_mesh, const char * _mesh_with_uv )
+// -tangent_ricci sophie.remesh.m sophie.uv.m [-wavefront]
+void _tangent_ricci( const char * _input_mesh, const char * _mesh_with_uv, bool wavefront )
 {
 	CRicciFlowVertex::traits = CRicciFlowVertex::traits | TRAIT_UV;
 
 	CRFMesh mesh;
-	mesh.read_m( _input_mesh );
+	if( !_read_mesh( mesh, _input_mesh, false ) ) return;
 
 	CTangentialRicciFlow<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
 	mapper._calculate_metric();
 
 	std::cout << "Metric has been calculated\n";
 
-	CRFEmbed embed( &mesh );
-	embed._embed();
-	mesh.write_m( _mesh_with_uv );
+	_embed_mesh( mesh, wavefront );
+	_write_mesh( mesh, _mesh_with_uv );
+}
+
+// -convert sophie.remesh.m sophie.remesh.mb, the vertex uv is kept if the input has it
+void _convert( const char * _input_mesh, const char * _output_mesh )
+{
+	CRFMesh mesh;
+	if( !_read_mesh( mesh, _input_mesh, true ) ) return;
+	if( _read_uv( mesh, _input_mesh ) )
+	{
+		CRicciFlowVertex::traits = CRicciFlowVertex::traits | TRAIT_UV;
+	}
+	//a .m file keeps the sharp edges in the edge strings, which .mb does not have
+	for( CRFMesh::MeshEdgeIterator eiter( &mesh ); !eiter.end(); eiter ++ )
+	{
+		CRicciFlowEdge * e = *eiter;
+		if( e->sharp() && e->string().find( "sharp" ) == std::string::npos )
+		{
+			e->string() += e->string().empty() ? "sharp" : " sharp";
+		}
+	}
+	_write_mesh( mesh, _output_mesh );
 }
 
 
@@ -82,19 +164,27 @@ std::cout << "You have entered " << argc
 //	std::cout << argv[i] << "\n";
 //}
 
+bool wavefront = ( argc == 5 && strcmp( argv[4], "-wavefront" ) == 0 );
+
 //-tangent_ricci_extremal_length sophie.remesh.m sophie.uv.m
-if( strcmp( argv[1] , "-tangent_ricci_extremal_length") == 0 && argc == 4)
+if( strcmp( argv[1] , "-tangent_ricci_extremal_length") == 0 && ( argc == 4 || wavefront ) )
+{
+	_tangent_ricci_extremal_length( argv[2], argv[3], wavefront );
+	return 0;
+}
+
+if( strcmp( argv[1] , "-tangent_ricci") == 0 && ( argc == 4 || wavefront ) )
 {
-	_tangent_ricci_extremal_length( argv[2], argv[3]);
+	_tangent_ricci( argv[2], argv[3], wavefront );
 	return 0;
 }
 
-if( strcmp( argv[1] , "-tangent_ricci") == 0 && argc == 4)
+if( strcmp( argv[1] , "-convert") == 0 && argc == 4)
 {
-	_tangent_ricci( argv[2], argv[3]);
+	_convert( argv[2], argv[3]);
 	return 0;
 }
 
 	return 0;
 }
- 
\ No newline at end of file
+ 
\ No newline at end of file
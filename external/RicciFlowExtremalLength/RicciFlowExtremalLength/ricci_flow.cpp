@@ -5,12 +5,21 @@
  * as a mex function
  * 
  * The calling syntax is
- * 	ricci_flow_extremal_length.cpp
+ * 	ricci_flow( command, meshFileIn, meshFileOut )
+ * 	[ uv, u, k ] = ricci_flow( command, F, V )
+ * 	[ uv, u, k ] = ricci_flow( command, F, V, S )
+ *
+ * where command is '-tangent_ricci_extremal_length' or '-tangent_ricci'.
+ * The array forms work without any file IO: F (#F x 3) and V (#V x 3)
+ * are the faces and vertices, S (#S x 2) the sharp edges marking the
+ * corners for the extremal length. They return the vertex uv, the log
+ * radii u and the vertex curvature k, ordered as V.
  *
  * This is a MEX-file for MATLAB
  * ==========================================================*/
 
 #include "mex.h" // for MATLAB
+#include "./ricci_flow_mex.h"
 
 #include "../MeshLib/algorithm/Structure/Structure.h"
 // for Extremal Lengths
@@ -56,7 +65,7 @@ void _tangent_ricci( const char * _input_mesh, const char * _mesh_with_uv )
 	CRicciFlowVertex::traits = CRicciFlowVertex::traits | TRAIT_UV;
 
 	CRFMesh mesh;
-	mesh.read_m( _input_mesh );
+	mesh.read_m( _input_mesh, false );
 
 	CTangentialRicciFlow<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
 	mapper._calculate_metric();
@@ -67,6 +76,29 @@ void _tangent_ricci( const char * _input_mesh, const char * _mesh_with_uv )
 }
 
 
+/***********************************************************
+ *
+ *  In memory versions, the mesh is built from MATLAB arrays
+ *
+ ***********************************************************/
+void _tangent_ricci_extremal_length( CRFMesh & mesh )
+{
+	CTangentialRicciFlowExtremalLength<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
+	mapper._calculate_metric();
+
+	CRFEmbed embed( &mesh );
+	embed._embed();
+}
+
+void _tangent_ricci( CRFMesh & mesh )
+{
+	CTangentialRicciFlow<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
+	mapper._calculate_metric();
+
+	CRFEmbed embed( &mesh );
+	embed._embed();
+}
+
 // Brief main function to call functionalities
 
 void mexFunction( int nlhs, mxArray *plhs[], 
@@ -77,6 +109,33 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	int i;
 	char *fCommand, *meshFileIn, *meshFileOut;
 
+	// Array input: ricci_flow( command, F, V [, S] )
+	if ((nrhs == 3 || nrhs == 4) && mxIsChar(prhs[0]) && !mxIsChar(prhs[1])){
+		// Check the command first, mexErrMsgIdAndTxt does not return
+		fCommand = mxArrayToString(prhs[0]);
+		bool extremalLength = strcmp(fCommand, "-tangent_ricci_extremal_length") == 0;
+		bool diskMap = strcmp(fCommand, "-tangent_ricci") == 0;
+		if( !extremalLength && !diskMap ) {
+			char msg[256];
+			snprintf(msg, sizeof(msg), "Unknown flow command %s.", fCommand);
+			mxFree(fCommand);
+			mexErrMsgIdAndTxt("MATLAB:ricci_flow:badCommand", "%s", msg);
+		}
+		mxFree(fCommand);
+
+		CRFMesh mesh;
+		_mesh_from_arrays(mesh, prhs[1], prhs[2], (nrhs == 4)? prhs[3] : NULL);
+
+		if( extremalLength ) {
+			_tangent_ricci_extremal_length(mesh);
+		} else {
+			_tangent_ricci(mesh);
+		}
+
+		_arrays_from_mesh(mesh, (int) mxGetM(prhs[2]), nlhs, plhs);
+		return;
+	}
+
 	// Check for proper number of arguments
 	if (nrhs != 3){
 		mexErrMsgIdAndTxt("MATLAB:ricci_flow:nargin",
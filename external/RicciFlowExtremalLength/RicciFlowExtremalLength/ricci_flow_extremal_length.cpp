@@ -5,12 +5,19 @@
  * as a mex function
  * 
  * The calling syntax is
- * 	ricci_flow_extremal_length.cpp
+ * 	ricci_flow_extremal_length( '-tangent_ricci_extremal_length', meshFileIn, meshFileOut )
+ * 	[ uv, u, k ] = ricci_flow_extremal_length( F, V, S )
+ *
+ * The second form works on MATLAB arrays without any file IO:
+ * F (#F x 3) and V (#V x 3) are the faces and vertices, S (#S x 2)
+ * the sharp edges marking the corners. It returns the vertex uv,
+ * the log radii u and the vertex curvature k, ordered as V.
  *
  * This is a MEX-file for MATLAB
  * ==========================================================*/
 
 #include "mex.h" // for MATLAB
+#include "./ricci_flow_mex.h"
 
 #include "../MeshLib/algorithm/Structure/Structure.h"
 // for Extremal Lengths
@@ -44,6 +51,14 @@ void _tangent_ricci_extremal_length( const char * _input_mesh, const char * _mes
 
 }
 
+void _tangent_ricci_extremal_length( CRFMesh & mesh ) {
+	CTangentialRicciFlowExtremalLength<CRicciFlowVertex,CRicciFlowEdge,CRicciFlowFace,CRicciFlowHalfEdge> mapper(&mesh);
+	mapper._calculate_metric();
+
+	CRFEmbed embed( &mesh );
+	embed._embed();
+}
+
 // Brief main function to call functionalities
 
 void mexFunction( int nlhs, mxArray *plhs[], 
@@ -54,6 +69,15 @@ void mexFunction( int nlhs, mxArray *plhs[],
 	int i;
 	char *fCommand, *meshFileIn, *meshFileOut;
 
+	// Array input: ricci_flow_extremal_length( F, V, S )
+	if (nrhs == 3 && !mxIsChar(prhs[0])){
+		CRFMesh mesh;
+		_mesh_from_arrays(mesh, prhs[0], prhs[1], prhs[2]);
+		_tangent_ricci_extremal_length(mesh);
+		_arrays_from_mesh(mesh, (int) mxGetM(prhs[1]), nlhs, plhs);
+		return;
+	}
+
 	// Check for proper number of arguments
 	if (nrhs != 3){
 		mexErrMsgIdAndTxt("MATLAB:ricci_flow_extremal_length:nargin",
@@ -0,0 +1,143 @@
+/*=============================================================
+ * ricci_flow_mex.h
+ *
+ * Conversion between MATLAB arrays and CRFMesh, shared by the
+ * Ricci flow MEX gateways. Meshes are passed as a face list F
+ * (#F x 3, one based), a vertex list V (#V x 3) and an optional
+ * list of sharp edges S (#S x 2, one based), all double arrays.
+ * ==========================================================*/
+
+#ifndef _RICCI_FLOW_MEX_H_
+#define _RICCI_FLOW_MEX_H_
+
+#include <vector>
+
+#include "mex.h" // for MATLAB
+
+#include "../MeshLib/algorithm/Riemannian/RicciFlow/RicciFlowMesh.h"
+
+using namespace MeshLib;
+
+/*!
+ *	Check that an input is a real double matrix with the given number of columns
+ */
+inline void _check_array( const mxArray * A, int cols, const char * name )
+{
+	if( !mxIsDouble( A ) || mxIsComplex( A ) || mxIsSparse( A ) )
+	{
+		mexErrMsgIdAndTxt( "MATLAB:ricci_flow:inputNotDouble",
+				"%s must be a real double array.", name );
+	}
+	if( !mxIsEmpty( A ) && (int) mxGetN( A ) != cols )
+	{
+		mexErrMsgIdAndTxt( "MATLAB:ricci_flow:inputSize",
+				"%s must have %d columns.", name, cols );
+	}
+}
+
+/*!
+ *	Build the mesh from MATLAB arrays, vertex i+1 of V gets id i+1
+ *	\param mesh the output mesh
+ *	\param F faces, #F x 3, one based
+ *	\param V vertices, #V x 3
+ *	\param S sharp edges, #S x 2, one based, may be NULL
+ */
+inline void _mesh_from_arrays( CRFMesh & mesh, const mxArray * F, const mxArray * V, const mxArray * S )
+{
+	_check_array( F, 3, "F" );
+	_check_array( V, 3, "V" );
+
+	int nf = (int) mxGetM( F );
+	int nv = (int) mxGetM( V );
+	const double * pF = mxGetPr( F );
+	const double * pV = mxGetPr( V );
+
+	// MATLAB arrays are column major
+	std::vector<double> points( 3 * nv );
+	for( int i = 0; i < nv; i ++ )
+		for( int j = 0; j < 3; j ++ )
+			points[3*i+j] = pV[ i + j * nv ];
+
+	// vertices no face uses are dropped by read_arrays
+	std::vector<int>  faces( 3 * nf );
+	std::vector<bool> referenced( nv, false );
+	for( int i = 0; i < nf; i ++ )
+		for( int j = 0; j < 3; j ++ )
+		{
+			int vid = (int) pF[ i + j * nf ];
+			if( vid < 1 || vid > nv )
+			{
+				mexErrMsgIdAndTxt( "MATLAB:ricci_flow:badFace",
+						"Face %d references vertex %d out of range.", i + 1, vid );
+			}
+			faces[3*i+j] = vid - 1;
+			referenced[ vid - 1 ] = true;
+		}
+
+	mesh.read_arrays( &points[0], nv, &faces[0], nf );
+
+	if( S == NULL || mxIsEmpty( S ) ) return;
+
+	_check_array( S, 2, "S" );
+	int ns = (int) mxGetM( S );
+	const double * pS = mxGetPr( S );
+	for( int i = 0; i < ns; i ++ )
+	{
+		int id0 = (int) pS[i];
+		int id1 = (int) pS[i + ns];
+		CRicciFlowEdge * e = NULL;
+		if( id0 >= 1 && id0 <= nv && referenced[ id0 - 1 ] &&
+			id1 >= 1 && id1 <= nv && referenced[ id1 - 1 ] )
+		{
+			e = mesh.vertexEdge( mesh.idVertex( id0 ), mesh.idVertex( id1 ) );
+		}
+		if( e == NULL )
+		{
+			mexErrMsgIdAndTxt( "MATLAB:ricci_flow:badEdge",
+					"Sharp edge %d is not an edge of the mesh.", i + 1 );
+		}
+		e->sharp() = true;
+	}
+}
+
+/*!
+ *	Copy the flow results to MATLAB arrays, ordered as the input V.
+ *	Vertices not referenced by any face are NaN.
+ *	\param mesh the mesh after the flow and the embedding
+ *	\param nv number of rows of the input V
+ *	\param nlhs number of requested outputs
+ *	\param plhs outputs { uv (#V x 2), u (#V x 1), k (#V x 1) }
+ */
+inline void _arrays_from_mesh( CRFMesh & mesh, int nv, int nlhs, mxArray * plhs[] )
+{
+	mxArray * uv = mxCreateDoubleMatrix( nv, 2, mxREAL );
+	mxArray * u  = mxCreateDoubleMatrix( nv, 1, mxREAL );
+	mxArray * k  = mxCreateDoubleMatrix( nv, 1, mxREAL );
+	double * pUV = mxGetPr( uv );
+	double * pU  = mxGetPr( u );
+	double * pK  = mxGetPr( k );
+
+	for( int i = 0; i < nv; i ++ )
+	{
+		pUV[i] = pUV[i + nv] = pU[i] = pK[i] = mxGetNaN();
+	}
+
+	for( CRFMesh::MeshVertexIterator viter( &mesh ); !viter.end(); viter ++ )
+	{
+		CRicciFlowVertex * v = *viter;
+		int i = v->id() - 1;
+		pUV[i]      = v->huv()[0];
+		pUV[i + nv] = v->huv()[1];
+		pU[i]       = v->u();
+		pK[i]       = v->k();
+	}
+
+	mxArray * out[3] = { uv, u, k };
+	for( int i = 0; i < 3; i ++ )
+	{
+		if( i < nlhs || ( i == 0 && nlhs == 0 ) ) plhs[i] = out[i];
+		else mxDestroyArray( out[i] );
+	}
+}
+
+#endif // _RICCI_FLOW_MEX_H_
@@ -0,0 +1,48 @@
+function T = bench_farthest_point_sampling_mesh(nverts, nbr_points)
+
+% bench_farthest_point_sampling_mesh - scaling in k of farthest point sampling.
+%
+%   T = bench_farthest_point_sampling_mesh(nverts, nbr_points);
+%
+%   Samples nbr_points(j) points on jittered grid meshes with about
+%   nverts(i) vertices with perform_farthest_point_sampling_mesh and
+%   prints the time, the time per point after the first one, and the
+%   mean number of vertices reached by the propagation of each point.
+%
+%   nverts: mesh sizes, default 1e6.
+%   nbr_points: numbers of points, default [10 100 1000 10000].
+%
+%   T(i,j) is the time in seconds for mesh i and nbr_points(j) points.
+
+if nargin<1 || isempty(nverts)
+    nverts = 1e6;
+end
+if nargin<2 || isempty(nbr_points)
+    nbr_points = [10 100 1000 10000];
+end
+
+T = zeros(length(nverts), length(nbr_points));
+rand('state', 0);
+
+for i=1:length(nverts)
+    % jittered grid with a slight bump, n x n vertices
+    n = round(sqrt(nverts(i)));
+    [X,Y] = meshgrid(0:n-1, 0:n-1);
+    X = X + 0.6*(rand(n)-0.5);
+    Y = Y + 0.6*(rand(n)-0.5);
+    Z = 0.2*sin(0.1*X).*cos(0.13*Y);
+    vertex = [X(:) Y(:) Z(:)]';
+    [I,J] = meshgrid(1:n-1, 1:n-1);
+    a = I(:) + (J(:)-1)*n; b = a+1; c = a+n; d = c+1;
+    faces = [a b d; a d c]';
+    nv = size(vertex,2);
+
+    for j=1:length(nbr_points)
+        tic;
+        [points,labels,D,Tk,Nk] = perform_farthest_point_sampling_mesh(vertex, faces, nbr_points(j));
+        T(i,j) = toc;
+        k = length(points);
+        fprintf('%8d vertices %6d points %8.3f s %8.3f ms/point %10.0f vertices/point\n', ...
+            nv, k, T(i,j), 1000*(Tk(end)-Tk(1))/max(k-1,1), mean(Nk(2:end)));
+    end
+end
@@ -0,0 +1,63 @@
+function T = bench_front_propagation_mesh(nverts, mex_names)
+
+% bench_front_propagation_mesh - throughput of perform_front_propagation_mesh.
+%
+%   T = bench_front_propagation_mesh(nverts, mex_names);
+%
+%   Runs a full front propagation from the center of jittered grid meshes
+%   with about nverts(i) vertices and prints the number of vertices
+%   processed per second.
+%
+%   nverts: mesh sizes, default [1e4 4e4 1.6e5 6.4e5 1e6].
+%   mex_names: cell array of compiled front propagation functions to
+%       compare, default {'perform_front_propagation_mesh'}. To compare
+%       against an older build, compile it under another name, e.g.
+%           mex -output perform_front_propagation_mesh_old ...
+%       and call
+%           bench_front_propagation_mesh([], {'perform_front_propagation_mesh_old', ...
+%               'perform_front_propagation_mesh'});
+%
+%   T(i,j) is the time in seconds for mesh i and function j. The distances
+%   returned by the different functions are checked to agree.
+
+if nargin<1 || isempty(nverts)
+    nverts = [1e4 4e4 1.6e5 6.4e5 1e6];
+end
+if nargin<2 || isempty(mex_names)
+    mex_names = {'perform_front_propagation_mesh'};
+end
+if ischar(mex_names)
+    mex_names = {mex_names};
+end
+
+T = zeros(length(nverts), length(mex_names));
+rand('state', 0);
+
+for i=1:length(nverts)
+    % jittered grid with a slight bump, n x n vertices
+    n = round(sqrt(nverts(i)));
+    [X,Y] = meshgrid(0:n-1, 0:n-1);
+    X = X + 0.6*(rand(n)-0.5);
+    Y = Y + 0.6*(rand(n)-0.5);
+    Z = 0.2*sin(0.1*X).*cos(0.13*Y);
+    vertex = [X(:) Y(:) Z(:)]';
+    [I,J] = meshgrid(1:n-1, 1:n-1);
+    a = I(:) + (J(:)-1)*n; b = a+1; c = a+n; d = c+1;
+    faces = [a b d; a d c]' - 1;
+    nv = size(vertex,2);
+
+    W = ones(nv,1);
+    start_points = floor(nv/2) + floor(n/2);
+    D0 = [];
+    for j=1:length(mex_names)
+        tic;
+        D = feval(mex_names{j}, vertex, faces, W, start_points, [], 1.2*nv, [], [], [], 1e9);
+        T(i,j) = toc;
+        fprintf('%-36s %8d vertices %8.3f s %10.0f vertices/s\n', mex_names{j}, nv, T(i,j), nv/T(i,j));
+        if isempty(D0)
+            D0 = D;
+        elseif max(abs(D-D0))>1e-9*max(D0)
+            warning('%s does not agree with %s', mex_names{j}, mex_names{1});
+        end
+    end
+end
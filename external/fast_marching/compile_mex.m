@@ -2,7 +2,6 @@
 disp('Compiling perform_front_propagation_mesh, might time some time.');
 
 files =  { ...
-    'perform_front_propagation_mesh.cpp', ...
     'gw/gw_core/GW_Config.cpp',           ...
     'gw/gw_core/GW_FaceIterator.cpp',     ...
     'gw/gw_core/GW_SmartCounter.cpp',     ...
@@ -18,10 +17,23 @@ files =  { ...
     'gw/gw_geodesic/GW_GeodesicVertex.cpp',                    ...  
     'gw/gw_geodesic/GW_TriangularInterpolation_Linear.cpp',      ...
     'gw/gw_geodesic/GW_TriangularInterpolation_Quadratic.cpp',  ...
+    'gw/gw_geodesic/GW_FurthestPointSampler.cpp',  ...
 };
-str = 'mex ';
+gw = '';
 for i=1:length(files)
-    str = [str files{i} ' '];
+    gw = [gw files{i} ' '];
 end
-eval(str);
+eval(['mex perform_front_propagation_mesh.cpp ' gw]);
+
+disp('Compiling geodesic_engine.');
+% C++11 threads
+if ispc
+    flags = '';
+else
+    flags = 'CXXFLAGS="$CXXFLAGS -std=c++11 -pthread" LDFLAGS="$LDFLAGS -pthread" ';
+end
+eval(['mex ' flags 'geodesic_engine.cpp ' gw]);
+
+disp('Compiling farthest_point_sampling_mesh.');
+eval(['mex ' flags 'farthest_point_sampling_mesh.cpp ' gw]);
 
@@ -0,0 +1,158 @@
+/*=================================================================
+% farthest_point_sampling_mesh - incremental farthest point sampling of a mesh.
+%
+%   [points,labels,D,T,N] = farthest_point_sampling_mesh(vertex, faces, nbr_points, start_points, W);
+%
+%   'vertex' is 3 x nverts and 'faces' is 3 x nfaces, zero based.
+%   Returns nbr_points points in total, start points included, each new
+%   one the farthest from the previous ones in the geodesic distance of
+%   the metric W (nverts x 1, optional). All the start points are returned
+%   even if there are more than nbr_points, and fewer points are returned
+%   once every vertex is at distance 0.
+%   'start_points' are the first points, zero based, optional. Without
+%   them the first point is the vertex farthest from vertex 0.
+%
+%   As in GW_VoronoiMesh::AddFurthestPoint, each new point only marches
+%   over the vertices it gets closer to. The vertex states are not reset
+%   over the whole mesh between two points and the farthest vertex is kept
+%   in a heap, which removes the two passes over the mesh of each point.
+%
+%   points are the points, start points included, zero based.
+%   labels(i) is the index in points of the point closest to vertex i,
+%   zero based, -1 if not reached. D is the distance to the points.
+%   T(k) is the time in seconds spent until points(k) was added, and
+%   N(k) the number of vertices its marching reached.
+*=================================================================*/
+
+#include <math.h>
+#include "config.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <list>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+using std::string;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+#include "mex.h"
+#include "front_propagation.h"
+#include "gw/gw_geodesic/GW_FurthestPointSampler.h"
+
+typedef std::chrono::steady_clock T_Clock;
+
+static double elapsed( T_Clock::time_point start )
+{
+	return std::chrono::duration<double>( T_Clock::now()-start ).count();
+}
+
+void mexFunction(	int nlhs, mxArray *plhs[],
+				 int nrhs, const mxArray*prhs[] )
+{
+	if( nrhs<3 )
+		mexErrMsgTxt("farthest_point_sampling_mesh(vertex, faces, nbr_points, start_points, W).");
+	if( nlhs>5 )
+		mexErrMsgTxt("at most 5 output arguments.");
+	if( mxGetM(prhs[0])!=3 )
+		mexErrMsgTxt("vertex must be of size 3 x nverts.");
+	if( mxGetM(prhs[1])!=3 )
+		mexErrMsgTxt("face must be of size 3 x nfaces.");
+	int nverts = (int) mxGetN(prhs[0]);
+	int nfaces = (int) mxGetN(prhs[1]);
+	double* vertex = mxGetPr(prhs[0]);
+	double* faces = mxGetPr(prhs[1]);
+	for( int i=0; i<3*nfaces; ++i )
+		if( faces[i]<0 || faces[i]>=nverts )
+			mexErrMsgTxt("faces must be zero based indices of vertices.");
+	int nbr_points = (int) *mxGetPr(prhs[2]);
+
+	double* start_points = NULL;
+	int nstart = 0;
+	if( nrhs>=4 && !mxIsEmpty(prhs[3]) )
+	{
+		start_points = mxGetPr(prhs[3]);
+		nstart = (int) mxGetNumberOfElements(prhs[3]);
+		for( int i=0; i<nstart; ++i )
+			if( start_points[i]<0 || start_points[i]>=nverts )
+				mexErrMsgTxt("start_points must be zero based indices of vertices.");
+	}
+	double* W = NULL;
+	if( nrhs>=5 && !mxIsEmpty(prhs[4]) )
+	{
+		if( (int) mxGetNumberOfElements(prhs[4])!=nverts )
+			mexErrMsgTxt("W must be of size nverts.");
+		W = mxGetPr(prhs[4]);
+	}
+
+	T_Clock::time_point start = T_Clock::now();
+
+	GW_GeodesicMesh Mesh;
+	build_geodesic_mesh( Mesh, vertex, nverts, faces, nfaces );
+
+	GW_FurthestPointSampler Sampler( Mesh );
+	Sampler.SetWeights( W );
+
+	// first points
+	T_GeodesicVertexList VertList;
+	if( nstart>0 )
+	{
+		for( int i=0; i<nstart; ++i )
+			VertList.push_back( (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]) );
+	}
+	else if( nbr_points>0 && nverts>0 )
+	{
+		VertList.push_back( (GW_GeodesicVertex*) Mesh.GetVertex(0) );
+		Sampler.SetStartVertices( VertList );
+		GW_GeodesicVertex* pFirst = Sampler.GetFurthestVertex();
+		VertList.clear();
+		VertList.push_back( pFirst!=NULL ? pFirst : (GW_GeodesicVertex*) Mesh.GetVertex(0) );
+	}
+	Sampler.SetStartVertices( VertList );
+
+	std::vector<double> T( Sampler.GetNbrSamples(), elapsed(start) );
+	std::vector<double> N( Sampler.GetNbrSamples(), nverts );
+
+	// farthest points
+	while( (int) Sampler.GetNbrSamples()<nbr_points )
+	{
+		if( Sampler.AddFurthestVertex()==NULL )
+			break;
+		T.push_back( elapsed(start) );
+		N.push_back( Sampler.GetNbrUpdatedVertex() );
+	}
+
+	// output result
+	int nsamples = (int) Sampler.GetNbrSamples();
+	plhs[0] = mxCreateDoubleMatrix(nsamples, 1, mxREAL);
+	double* points = mxGetPr(plhs[0]);
+	for( int k=0; k<nsamples; ++k )
+		points[k] = Sampler.GetSample(k)->GetID();
+	if( nlhs>=2 )
+	{
+		plhs[1] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		double* labels = mxGetPr(plhs[1]);
+		for( int i=0; i<nverts; ++i )
+			labels[i] = Sampler.GetLabel( *(GW_GeodesicVertex*) Mesh.GetVertex(i) );
+	}
+	if( nlhs>=3 )
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, 1, mxREAL);
+		double* D = mxGetPr(plhs[2]);
+		for( int i=0; i<nverts; ++i )
+			D[i] = ((GW_GeodesicVertex*) Mesh.GetVertex(i))->GetDistance();
+	}
+	if( nlhs>=4 )
+	{
+		plhs[3] = mxCreateDoubleMatrix(nsamples, 1, mxREAL);
+		std::copy( T.begin(), T.end(), mxGetPr(plhs[3]) );
+	}
+	if( nlhs>=5 )
+	{
+		plhs[4] = mxCreateDoubleMatrix(nsamples, 1, mxREAL);
+		std::copy( N.begin(), N.end(), mxGetPr(plhs[4]) );
+	}
+}
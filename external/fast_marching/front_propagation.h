@@ -0,0 +1,178 @@
+/*=================================================================
+% front_propagation.h - Fast Marching front propagation on a GW_GeodesicMesh.
+%
+%   Shared by perform_front_propagation_mesh and geodesic_engine.
+%   All the parameters of a propagation are kept in a T_FrontPropagation
+%   given to the callbacks as user data, so that several meshes can be
+%   marched at the same time from different threads.
+*=================================================================*/
+
+#ifndef _FRONT_PROPAGATION_H_
+#define _FRONT_PROPAGATION_H_
+
+#include <math.h>
+#include "config.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <list>
+#include <string>
+#include <iostream>
+using std::string;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+#include "gw/gw_core/GW_Config.h"
+#include "gw/gw_core/GW_MathsWrapper.h"
+#include "gw/gw_geodesic/GW_GeodesicMesh.h"
+using namespace GW;
+
+/** parameters and state of one front propagation */
+struct T_FrontPropagation
+{
+	double* Ww;				// weight, nverts x 1
+	double* H;				// heuristic, may be NULL
+	double* L;				// bound on current distance, may be NULL
+	const char* is_end;		// is_end[i]!=0 if vertex i is an end point, may be NULL
+	int niter_max;
+	double dmax;
+	int nbr_iter;			// number of insertions so far
+
+	T_FrontPropagation()
+	:	Ww( NULL ), H( NULL ), L( NULL ), is_end( NULL ),
+		niter_max( -1 ), dmax( 1e9 ), nbr_iter( 0 )
+	{}
+};
+
+inline GW_Float WeightCallback( GW_GeodesicVertex& Vert, void* pData )
+{
+	T_FrontPropagation* fp = (T_FrontPropagation*) pData;
+	GW_U32 i = Vert.GetID();
+	return fp->Ww[i];
+}
+
+inline GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert, void* pData )
+{
+	// check if the end point has been reached
+	T_FrontPropagation* fp = (T_FrontPropagation*) pData;
+	GW_U32 i = Vert.GetID();
+	if( Vert.GetDistance()>fp->dmax )
+		return true;
+	return fp->is_end!=NULL && fp->is_end[i]!=0;
+}
+
+inline GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pData )
+{
+	// check if the distance of the new point is less than the given distance
+	T_FrontPropagation* fp = (T_FrontPropagation*) pData;
+	GW_U32 i = Vert.GetID();
+	bool doinsersion = fp->nbr_iter<=fp->niter_max;
+	if( fp->L!=NULL )
+		doinsersion = doinsersion && (rNewDist<fp->L[i]);
+	fp->nbr_iter++;
+	return doinsersion;
+}
+
+inline GW_Float HeuristicCallback( GW_GeodesicVertex& Vert, void* pData )
+{
+	// return the heuristic distance
+	T_FrontPropagation* fp = (T_FrontPropagation*) pData;
+	GW_U32 i = Vert.GetID();
+	return fp->H[i];
+}
+
+/** mark the end points, is_end must have nverts entries */
+inline void mark_end_points( std::vector<char>& is_end, int nverts, const double* end_points, int nend )
+{
+	is_end.assign( nverts, 0 );
+	for( int k=0; k<nend; ++k )
+	{
+		int i = (int) end_points[k];
+		if( i>=0 && i<nverts )
+			is_end[i] = 1;
+	}
+}
+
+/** build the mesh, faces are zero based, 3 x nfaces */
+inline void build_geodesic_mesh( GW_GeodesicMesh& Mesh, const double* vertex, int nverts, const double* faces, int nfaces )
+{
+	Mesh.SetNbrVertex(nverts);
+	for( int i=0; i<nverts; ++i )
+	{
+		GW_GeodesicVertex& vert = (GW_GeodesicVertex&) Mesh.CreateNewVertex();
+		vert.SetPosition( GW_Vector3D(vertex[3*i],vertex[3*i+1],vertex[3*i+2]) );
+		Mesh.SetVertex(i, &vert);
+	}
+	Mesh.SetNbrFace(nfaces);
+	for( int i=0; i<nfaces; ++i )
+	{
+		GW_GeodesicFace& face = (GW_GeodesicFace&) Mesh.CreateNewFace();
+		GW_Vertex* v1 = Mesh.GetVertex((int) faces[3*i]);   GW_ASSERT( v1!=NULL );
+		GW_Vertex* v2 = Mesh.GetVertex((int) faces[3*i+1]); GW_ASSERT( v2!=NULL );
+		GW_Vertex* v3 = Mesh.GetVertex((int) faces[3*i+2]); GW_ASSERT( v3!=NULL );
+		face.SetVertex( *v1,*v2,*v3 );
+		Mesh.SetFace(i, &face);
+	}
+	Mesh.BuildConnectivity();
+}
+
+/** run one propagation from the given start points, zero based.
+	values, if not NULL, are the initial distances of the start points.
+	D, S, Q receive the distance, the state and the nearest start point
+	of each vertex, each may be NULL. */
+inline void perform_front_propagation( GW_GeodesicMesh& Mesh, T_FrontPropagation& fp,
+						const double* start_points, int nstart, const double* values,
+						double* D, double* S, double* Q )
+{
+	fp.nbr_iter = 0;
+
+	// set up fast marching
+	Mesh.ResetGeodesicMesh();
+	for( int i=0; i<nstart; ++i )
+	{
+		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
+		GW_ASSERT( v!=NULL );
+		Mesh.AddStartVertex( *v );
+	}
+	Mesh.SetUpFastMarching();
+	Mesh.RegisterCallbackData( &fp );
+	Mesh.RegisterWeightCallbackFunctionData( WeightCallback );
+	Mesh.RegisterForceStopCallbackFunctionData( StopMarchingCallback );
+	Mesh.RegisterVertexInsersionCallbackFunctionData( InsersionCallback );
+	if( fp.H!=NULL )
+		Mesh.RegisterHeuristicToGoalCallbackFunctionData( HeuristicCallback );
+	// initialize the distance of the starting points
+	if( values!=NULL )
+	for( int i=0; i<nstart; ++i )
+	{
+		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
+		GW_ASSERT( v!=NULL );
+		v->SetDistance( values[i] );
+	}
+
+	// perform fast marching
+	Mesh.PerformFastMarching();
+
+	// output result
+	int nverts = Mesh.GetNbrVertex();
+	for( int i=0; i<nverts; ++i )
+	{
+		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) i);
+		GW_ASSERT( v!=NULL );
+		if( D!=NULL )
+			D[i] = v->GetDistance();
+		if( S!=NULL )
+			S[i] = v->GetState();
+		if( Q!=NULL )
+		{
+			GW_GeodesicVertex* v1 = v->GetFront();
+			if( v1==NULL )
+				Q[i] = -1;
+			else
+				Q[i] = v1->GetID();
+		}
+	}
+}
+
+#endif // _FRONT_PROPAGATION_H_
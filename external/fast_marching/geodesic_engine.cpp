@@ -0,0 +1,268 @@
+/*=================================================================
+% geodesic_engine - persistent mesh for batches of Fast Marching propagations.
+%
+%   engine = geodesic_engine('create', vertex, faces, nthreads);
+%   [D,Q,S] = geodesic_engine('query', engine, start_points, W, end_points, nb_iter_max, L, dmax);
+%   geodesic_engine('delete', engine);
+%
+%   'create' builds the mesh once, 'vertex' is 3 x nverts and 'faces' is
+%   3 x nfaces, zero based. 'nthreads' is the number of worker threads,
+%   0 or omitted for the number of cores. Each worker keeps its own copy
+%   of the mesh, built the first time it is used.
+%
+%   'query' runs one propagation per seed set, the seed sets being
+%   processed in parallel. 'start_points' is either a cell array of
+%   zero based index vectors, one per seed set, or a numeric vector,
+%   each entry being a seed set of one point. The other arguments are
+%   optional and shared by all the seed sets, with the meaning they have
+%   in perform_front_propagation_mesh; pass [] for the default.
+%   D, Q and S are nverts x nsets: the distance, the nearest seed (zero
+%   based, -1 if not reached) and the state of each vertex.
+%
+%   'delete' frees the mesh. All engines are freed when the MEX file is
+%   cleared.
+*=================================================================*/
+
+#include <math.h>
+#include "config.h"
+#include <algorithm>
+#include <map>
+#include <vector>
+#include <list>
+#include <string>
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <atomic>
+#include <thread>
+using std::string;
+using std::cerr;
+using std::cout;
+using std::endl;
+
+#include "mex.h"
+#include "front_propagation.h"
+
+
+/** a mesh built once and marched many times */
+class T_GeodesicEngine
+{
+public:
+	T_GeodesicEngine( const double* vertex, int nverts, const double* faces, int nfaces, int nthreads )
+	:	vertex_( vertex, vertex+3*nverts ),
+		faces_( faces, faces+3*nfaces ),
+		Meshes_( nthreads, (GW_GeodesicMesh*) NULL )
+	{}
+
+	~T_GeodesicEngine()
+	{
+		for( size_t i=0; i<Meshes_.size(); ++i )
+			delete Meshes_[i];
+	}
+
+	int GetNbrVertex()	{ return (int) vertex_.size()/3; }
+	int GetNbrThread()	{ return (int) Meshes_.size(); }
+
+	/** mesh of a worker, built on first use */
+	GW_GeodesicMesh& GetMesh( int nThread )
+	{
+		if( Meshes_[nThread]==NULL )
+		{
+			Meshes_[nThread] = new GW_GeodesicMesh;
+			build_geodesic_mesh( *Meshes_[nThread], &vertex_[0], GetNbrVertex(), &faces_[0], (int) faces_.size()/3 );
+		}
+		return *Meshes_[nThread];
+	}
+
+private:
+	std::vector<double> vertex_;
+	std::vector<double> faces_;
+	std::vector<GW_GeodesicMesh*> Meshes_;
+};
+
+typedef std::map<int, T_GeodesicEngine*> T_GeodesicEngineMap;
+static T_GeodesicEngineMap engines;
+static int next_engine = 1;
+
+static void delete_engines()
+{
+	for( T_GeodesicEngineMap::iterator it=engines.begin(); it!=engines.end(); ++it )
+		delete it->second;
+	engines.clear();
+}
+
+static T_GeodesicEngine* get_engine( const mxArray* A )
+{
+	if( !mxIsDouble(A) || mxGetNumberOfElements(A)!=1 )
+		mexErrMsgTxt("engine must be a scalar returned by geodesic_engine('create',...).");
+	T_GeodesicEngineMap::iterator it = engines.find( (int) *mxGetPr(A) );
+	if( it==engines.end() )
+		mexErrMsgTxt("invalid or deleted engine.");
+	return it->second;
+}
+
+/** an optional array argument, NULL if absent or empty */
+static double* get_optional( int nrhs, const mxArray* prhs[], int k, int nverts, const char* name )
+{
+	if( nrhs<=k || mxIsEmpty(prhs[k]) )
+		return NULL;
+	if( nverts>=0 && (int) mxGetNumberOfElements(prhs[k])!=nverts )
+	{
+		char str[128];
+		sprintf(str, "%s must be of size nverts.", name);
+		mexErrMsgTxt(str);
+	}
+	return mxGetPr(prhs[k]);
+}
+
+static void create( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[] )
+{
+	if( nrhs<3 )
+		mexErrMsgTxt("geodesic_engine('create', vertex, faces, nthreads).");
+	if( mxGetM(prhs[1])!=3 )
+		mexErrMsgTxt("vertex must be of size 3 x nverts.");
+	if( mxGetM(prhs[2])!=3 )
+		mexErrMsgTxt("face must be of size 3 x nfaces.");
+	int nverts = (int) mxGetN(prhs[1]);
+	int nfaces = (int) mxGetN(prhs[2]);
+	double* faces = mxGetPr(prhs[2]);
+	for( int i=0; i<3*nfaces; ++i )
+		if( faces[i]<0 || faces[i]>=nverts )
+			mexErrMsgTxt("faces must be zero based indices of vertices.");
+
+	int nthreads = 0;
+	if( nrhs>=4 && !mxIsEmpty(prhs[3]) )
+		nthreads = (int) *mxGetPr(prhs[3]);
+	if( nthreads<=0 )
+		nthreads = std::max( 1, (int) std::thread::hardware_concurrency() );
+
+	int id = next_engine++;
+	engines[id] = new T_GeodesicEngine( mxGetPr(prhs[1]), nverts, faces, nfaces, nthreads );
+	plhs[0] = mxCreateDoubleScalar( id );
+}
+
+static void query( int nlhs, mxArray *plhs[], int nrhs, const mxArray*prhs[] )
+{
+	if( nrhs<3 )
+		mexErrMsgTxt("geodesic_engine('query', engine, start_points, ...).");
+	T_GeodesicEngine* engine = get_engine( prhs[1] );
+	int nverts = engine->GetNbrVertex();
+
+	// seed sets
+	std::vector<const double*> sets;
+	std::vector<int> nstart;
+	const mxArray* seeds = prhs[2];
+	if( mxIsCell(seeds) )
+	{
+		for( size_t k=0; k<mxGetNumberOfElements(seeds); ++k )
+		{
+			const mxArray* c = mxGetCell(seeds, k);
+			if( c==NULL || !mxIsDouble(c) || mxIsEmpty(c) )
+				mexErrMsgTxt("each seed set must be a non empty double array.");
+			sets.push_back( mxGetPr(c) );
+			nstart.push_back( (int) mxGetNumberOfElements(c) );
+		}
+	}
+	else
+	{
+		if( !mxIsDouble(seeds) )
+			mexErrMsgTxt("start_points must be a cell array or a double array.");
+		for( size_t k=0; k<mxGetNumberOfElements(seeds); ++k )
+		{
+			sets.push_back( mxGetPr(seeds)+k );
+			nstart.push_back( 1 );
+		}
+	}
+	int nsets = (int) sets.size();
+	for( int k=0; k<nsets; ++k )
+		for( int i=0; i<nstart[k]; ++i )
+			if( sets[k][i]<0 || sets[k][i]>=nverts )
+				mexErrMsgTxt("start_points must be zero based indices of vertices.");
+
+	// shared parameters
+	std::vector<double> W_default;
+	double* Ww = get_optional( nrhs, prhs, 3, nverts, "W" );
+	if( Ww==NULL )
+	{
+		W_default.assign( nverts, 1 );
+		Ww = &W_default[0];
+	}
+	std::vector<char> is_end;
+	double* end_points = get_optional( nrhs, prhs, 4, -1, "end_points" );
+	if( end_points!=NULL )
+		mark_end_points( is_end, nverts, end_points, (int) mxGetNumberOfElements(prhs[4]) );
+	double* niter = get_optional( nrhs, prhs, 5, -1, "nb_iter_max" );
+	double* L = get_optional( nrhs, prhs, 6, nverts, "L" );
+	double* dmax = get_optional( nrhs, prhs, 7, -1, "dmax" );
+
+	T_FrontPropagation fp;
+	fp.Ww = Ww;
+	fp.L = L;
+	fp.is_end = is_end.empty() ? NULL : &is_end[0];
+	fp.niter_max = niter!=NULL ? (int) std::min( *niter, 2e9 ) : 2000000000;
+	if( dmax!=NULL )
+		fp.dmax = *dmax;
+
+	plhs[0] = mxCreateDoubleMatrix(nverts, nsets, mxREAL);
+	double* D = mxGetPr(plhs[0]);
+	double* Q = NULL;
+	double* S = NULL;
+	if( nlhs>=2 )
+	{
+		plhs[1] = mxCreateDoubleMatrix(nverts, nsets, mxREAL);
+		Q = mxGetPr(plhs[1]);
+	}
+	if( nlhs>=3 )
+	{
+		plhs[2] = mxCreateDoubleMatrix(nverts, nsets, mxREAL);
+		S = mxGetPr(plhs[2]);
+	}
+
+	// each worker takes the next seed set, with its own mesh and propagation state
+	std::atomic<int> next( 0 );
+	int nthreads = std::min( engine->GetNbrThread(), nsets );
+	std::vector<std::thread> workers;
+	for( int t=0; t<nthreads; ++t )
+	{
+		workers.push_back( std::thread( [&,t]()
+		{
+			GW_GeodesicMesh& Mesh = engine->GetMesh( t );
+			T_FrontPropagation fpt = fp;
+			for( int k=next++; k<nsets; k=next++ )
+			{
+				size_t offset = (size_t) k*nverts;
+				perform_front_propagation( Mesh, fpt, sets[k], nstart[k], NULL, D+offset,
+					S!=NULL ? S+offset : NULL, Q!=NULL ? Q+offset : NULL );
+			}
+		} ) );
+	}
+	for( int t=0; t<nthreads; ++t )
+		workers[t].join();
+}
+
+void mexFunction(	int nlhs, mxArray *plhs[],
+				 int nrhs, const mxArray*prhs[] )
+{
+	mexAtExit( delete_engines );
+
+	if( nrhs<1 || !mxIsChar(prhs[0]) )
+		mexErrMsgTxt("first argument must be 'create', 'query' or 'delete'.");
+	char* command = mxArrayToString(prhs[0]);
+	string cmd( command );
+	mxFree( command );
+
+	if( cmd=="create" )
+		create( nlhs, plhs, nrhs, prhs );
+	else if( cmd=="query" )
+		query( nlhs, plhs, nrhs, prhs );
+	else if( cmd=="delete" )
+	{
+		if( nrhs<2 )
+			mexErrMsgTxt("geodesic_engine('delete', engine).");
+		T_GeodesicEngine* engine = get_engine( prhs[1] );
+		engines.erase( (int) *mxGetPr(prhs[1]) );
+		delete engine;
+	}
+	else
+		mexErrMsgTxt("unknown command.");
+}
@@ -0,0 +1,343 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FurthestPointSampler.cpp
+ *  \brief  Definition of class \c GW_FurthestPointSampler
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#include "stdafx.h"
+#include "GW_FurthestPointSampler.h"
+
+using namespace GW;
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler constructor
+/**
+ *  \param  Mesh [GW_GeodesicMesh&] The mesh to sample, its connectivity must be built.
+ *  \date   10-16-2026
+ *
+ *  Constructor. No vertex is sampled until SetStartVertices is called.
+ */
+/*------------------------------------------------------------------------------*/
+GW_FurthestPointSampler::GW_FurthestPointSampler( GW_GeodesicMesh& Mesh )
+:	Mesh_		( Mesh ),
+	pWeights_	( NULL )
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler destructor
+/**
+ *  \date   10-16-2026
+ *
+ *  Destructor.
+ */
+/*------------------------------------------------------------------------------*/
+GW_FurthestPointSampler::~GW_FurthestPointSampler()
+{
+	/* NOTHING */
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::SetWeights
+/**
+ *  \param  pWeights [const GW_Float*] Weight of each vertex, NULL for the metric of the mesh.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FurthestPointSampler::SetWeights( const GW_Float* pWeights )
+{
+	pWeights_ = pWeights;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::SetStartVertices
+/**
+ *  \param  VertList [T_GeodesicVertexList&] The first samples, may be empty.
+ *  \date   10-16-2026
+ *
+ *  Restart the sampling from a list of vertices, with one full marching.
+ *  With an empty list every vertex is at infinite distance, and the first
+ *  furthest vertex is the first vertex of the mesh.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FurthestPointSampler::SetStartVertices( T_GeodesicVertexList& VertList )
+{
+	GW_U32 nNbrVertex = Mesh_.GetNbrVertex();
+
+	Mesh_.ResetGeodesicMesh();
+	if( !VertList.empty() )
+	{
+		for( IT_GeodesicVertexList it = VertList.begin(); it!=VertList.end(); ++it )
+		{
+			GW_GeodesicVertex* pVert = *it;
+			GW_ASSERT( pVert!=NULL );
+			Mesh_.AddStartVertex( *pVert );
+		}
+		this->March( NULL );
+	}
+
+	/* the next samples march over the vertices as if they were not reached yet */
+	Heap_.clear();
+	Heap_.reserve( nNbrVertex );
+	HeapPosition_.assign( nNbrVertex, -1 );
+	for( GW_U32 i=0; i<nNbrVertex; ++i )
+	{
+		GW_GeodesicVertex* pVert = (GW_GeodesicVertex*) Mesh_.GetVertex( i );
+		GW_ASSERT( pVert!=NULL );
+		pVert->SetState( GW_GeodesicVertex::kFar );
+		/* isolated vertices are never selected */
+		if( pVert->GetFace()!=NULL )
+		{
+			T_Entry Entry = { pVert->GetDistance(), pVert };
+			HeapPosition_[ pVert->GetID() ] = (GW_I32) Heap_.size();
+			Heap_.push_back( Entry );
+		}
+	}
+	for( GW_I32 i=(GW_I32) Heap_.size()/2-1; i>=0; --i )
+		this->SiftDown( (GW_U32) i );
+
+	Samples_.clear();
+	SampleNumber_.assign( nNbrVertex, -1 );
+	for( IT_GeodesicVertexList it = VertList.begin(); it!=VertList.end(); ++it )
+		this->AddSample( **it );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::AddVertex
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The new sample.
+ *  \date   10-16-2026
+ *
+ *  March from a new sample over the vertices whose distance it decreases,
+ *  then update their key in the heap.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FurthestPointSampler::AddVertex( GW_GeodesicVertex& Vert )
+{
+	GW_ASSERT( HeapPosition_.size()==Mesh_.GetNbrVertex() );
+
+	this->March( &Vert );
+
+	for( IT_GeodesicVertexVector it = UpdatedVertex_.begin(); it!=UpdatedVertex_.end(); ++it )
+	{
+		GW_GeodesicVertex* pVert = *it;
+		pVert->SetState( GW_GeodesicVertex::kFar );
+		GW_I32 nPos = HeapPosition_[ pVert->GetID() ];
+		if( nPos>=0 )
+		{
+			/* the distance can only decrease */
+			GW_ASSERT( pVert->GetDistance()<=Heap_[nPos].rDistance_ );
+			Heap_[nPos].rDistance_ = pVert->GetDistance();
+			this->SiftDown( (GW_U32) nPos );
+		}
+	}
+
+	this->AddSample( Vert );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::AddFurthestVertex
+/**
+ *  \return [GW_GeodesicVertex*] The new sample, NULL if every vertex is a sample.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_GeodesicVertex* GW_FurthestPointSampler::AddFurthestVertex()
+{
+	GW_GeodesicVertex* pVert = this->GetFurthestVertex();
+	if( pVert!=NULL )
+		this->AddVertex( *pVert );
+	return pVert;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::GetFurthestVertex
+/**
+ *  \return [GW_GeodesicVertex*] The vertex furthest from the samples, NULL if every vertex is a sample.
+ *  \date   10-16-2026
+ *
+ *  Among vertices at the same distance, the one with the lowest ID.
+ */
+/*------------------------------------------------------------------------------*/
+GW_GeodesicVertex* GW_FurthestPointSampler::GetFurthestVertex()
+{
+	if( Heap_.empty() || Heap_[0].rDistance_<=0 )
+		return NULL;
+	return Heap_[0].pVert_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::GetNbrSamples
+/**
+ *  \return [GW_U32] Number of samples, start vertices included.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_U32 GW_FurthestPointSampler::GetNbrSamples()
+{
+	return (GW_U32) Samples_.size();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::GetSample
+/**
+ *  \param  nNum [GW_U32] Number of the sample, in the order they were added.
+ *  \return [GW_GeodesicVertex*] The sample.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_GeodesicVertex* GW_FurthestPointSampler::GetSample( GW_U32 nNum )
+{
+	GW_ASSERT( nNum<Samples_.size() );
+	return Samples_[nNum];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::GetLabel
+/**
+ *  \param  Vert [GW_GeodesicVertex&] A vertex.
+ *  \return [GW_I32] Number of the closest sample, -1 if the vertex is not reached.
+ *  \date   10-16-2026
+ *
+ *  The geodesic Voronoi cell of the vertex.
+ */
+/*------------------------------------------------------------------------------*/
+GW_I32 GW_FurthestPointSampler::GetLabel( GW_GeodesicVertex& Vert )
+{
+	GW_GeodesicVertex* pFront = Vert.GetFront();
+	if( pFront==NULL )
+		return -1;
+	return SampleNumber_[ pFront->GetID() ];
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::GetNbrUpdatedVertex
+/**
+ *  \return [GW_U32] Number of vertices reached by the last marching.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_U32 GW_FurthestPointSampler::GetNbrUpdatedVertex()
+{
+	return (GW_U32) UpdatedVertex_.size();
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::March
+/**
+ *  \param  pStartVert [GW_GeodesicVertex*] A start vertex to add, may be NULL.
+ *  \date   10-16-2026
+ *
+ *  Perform a marching that only inserts the vertices whose distance
+ *  decreases, and record the vertices it reaches.
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FurthestPointSampler::March( GW_GeodesicVertex* pStartVert )
+{
+	UpdatedVertex_.clear();
+
+	Mesh_.RegisterCallbackData( this );
+	if( pWeights_!=NULL )
+		Mesh_.RegisterWeightCallbackFunctionData( GW_FurthestPointSampler::WeightCallback );
+	Mesh_.RegisterVertexInsersionCallbackFunctionData( GW_FurthestPointSampler::VertexInsersionCallback );
+	Mesh_.RegisterNewDeadVertexCallbackFunctionData( GW_FurthestPointSampler::NewDeadVertexCallback );
+
+	Mesh_.PerformFastMarching( pStartVert );
+
+	/* do not leave a pointer to this sampler in the mesh */
+	if( pWeights_!=NULL )
+		Mesh_.RegisterWeightCallbackFunctionData( NULL );
+	Mesh_.RegisterVertexInsersionCallbackFunctionData( NULL );
+	Mesh_.RegisterNewDeadVertexCallbackFunctionData( NULL );
+	Mesh_.RegisterCallbackData( NULL );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler::AddSample
+/**
+ *  \param  Vert [GW_GeodesicVertex&] The sample.
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+void GW_FurthestPointSampler::AddSample( GW_GeodesicVertex& Vert )
+{
+	SampleNumber_[ Vert.GetID() ] = (GW_I32) Samples_.size();
+	Samples_.push_back( &Vert );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler callbacks
+/**
+ *  \date   10-16-2026
+ *
+ *  The sampler is given as user data.
+ */
+/*------------------------------------------------------------------------------*/
+GW_Float GW_FurthestPointSampler::WeightCallback( GW_GeodesicVertex& Vert, void* pData )
+{
+	GW_FurthestPointSampler* pSampler = (GW_FurthestPointSampler*) pData;
+	return pSampler->pWeights_[ Vert.GetID() ];
+}
+
+GW_Bool GW_FurthestPointSampler::VertexInsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pData )
+{
+	/* only march where the distance decreases */
+	return Vert.GetDistance()>rNewDist;
+}
+
+void GW_FurthestPointSampler::NewDeadVertexCallback( GW_GeodesicVertex& Vert, void* pData )
+{
+	GW_FurthestPointSampler* pSampler = (GW_FurthestPointSampler*) pData;
+	pSampler->UpdatedVertex_.push_back( &Vert );
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_FurthestPointSampler heap
+/**
+ *  \date   10-16-2026
+ *
+ *  Binary max-heap. Keys only decrease, so entries are only sifted down.
+ */
+/*------------------------------------------------------------------------------*/
+GW_Bool GW_FurthestPointSampler::IsBefore( GW_U32 nPos1, GW_U32 nPos2 )
+{
+	const T_Entry& e1 = Heap_[nPos1];
+	const T_Entry& e2 = Heap_[nPos2];
+	if( e1.rDistance_!=e2.rDistance_ )
+		return e1.rDistance_>e2.rDistance_;
+	return e1.pVert_->GetID()<e2.pVert_->GetID();
+}
+
+void GW_FurthestPointSampler::HeapSwap( GW_U32 nPos1, GW_U32 nPos2 )
+{
+	T_Entry Entry = Heap_[nPos1];
+	Heap_[nPos1] = Heap_[nPos2];
+	Heap_[nPos2] = Entry;
+	HeapPosition_[ Heap_[nPos1].pVert_->GetID() ] = (GW_I32) nPos1;
+	HeapPosition_[ Heap_[nPos2].pVert_->GetID() ] = (GW_I32) nPos2;
+}
+
+void GW_FurthestPointSampler::SiftDown( GW_U32 nPos )
+{
+	GW_U32 nSize = (GW_U32) Heap_.size();
+	while( GW_True )
+	{
+		GW_U32 nChild = 2*nPos+1;
+		if( nChild>=nSize )
+			break;
+		if( nChild+1<nSize && this->IsBefore( nChild+1, nChild ) )
+			nChild++;
+		if( !this->IsBefore( nChild, nPos ) )
+			break;
+		this->HeapSwap( nPos, nChild );
+		nPos = nChild;
+	}
+}
+
+
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,115 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_FurthestPointSampler.h
+ *  \brief  Definition of class \c GW_FurthestPointSampler
+ *  \date   10-16-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_FURTHESTPOINTSAMPLER_H_
+#define _GW_FURTHESTPOINTSAMPLER_H_
+
+#include "../gw_core/GW_Config.h"
+#include "GW_GeodesicMesh.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_FurthestPointSampler
+ *  \brief  Incremental furthest point sampling of a mesh.
+ *  \date   10-16-2026
+ *
+ *  The distance to the current samples is kept in the vertices of the mesh
+ *  between two samples. As in GW_VoronoiMesh::AddFurthestPoint, a new sample
+ *  only marches over the vertices whose distance it decreases. Only these
+ *  vertices are reset afterward, and the furthest vertex is the top of a
+ *  max-heap on the distance, whose keys are decreased for the vertices
+ *  reached by each new sample. Adding a sample thus avoids the two passes
+ *  over the whole mesh of ResetOnlyVertexState and FindMaxVertex.
+ *
+ *  The state of the sampling is given to the callbacks as user data, so
+ *  several meshes can be sampled at the same time. The metric is the one of
+ *  the mesh unless weights are given with SetWeights.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_FurthestPointSampler
+{
+
+public:
+
+    /*------------------------------------------------------------------------------*/
+    /** \name Constructor and destructor */
+    /*------------------------------------------------------------------------------*/
+    //@{
+	GW_FurthestPointSampler( GW_GeodesicMesh& Mesh );
+	virtual ~GW_FurthestPointSampler();
+    //@}
+
+	/** weight of each vertex, indexed by ID, NULL to use the metric of the mesh */
+	void SetWeights( const GW_Float* pWeights );
+
+	//-------------------------------------------------------------------------
+    /** \name Sampling. */
+    //-------------------------------------------------------------------------
+    //@{
+	void SetStartVertices( T_GeodesicVertexList& VertList );
+	void AddVertex( GW_GeodesicVertex& Vert );
+	GW_GeodesicVertex* AddFurthestVertex();
+	GW_GeodesicVertex* GetFurthestVertex();
+	//@}
+
+	//-------------------------------------------------------------------------
+    /** \name Results. */
+    //-------------------------------------------------------------------------
+    //@{
+	GW_U32 GetNbrSamples();
+	GW_GeodesicVertex* GetSample( GW_U32 nNum );
+	GW_I32 GetLabel( GW_GeodesicVertex& Vert );
+	GW_U32 GetNbrUpdatedVertex();
+	//@}
+
+private:
+
+	static GW_Float WeightCallback( GW_GeodesicVertex& Vert, void* pData );
+	static GW_Bool VertexInsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pData );
+	static void NewDeadVertexCallback( GW_GeodesicVertex& Vert, void* pData );
+
+	void March( GW_GeodesicVertex* pStartVert );
+	void AddSample( GW_GeodesicVertex& Vert );
+
+	/** max-heap on the distance of the vertices, ties broken by lowest ID */
+	GW_Bool IsBefore( GW_U32 nPos1, GW_U32 nPos2 );
+	void HeapSwap( GW_U32 nPos1, GW_U32 nPos2 );
+	void SiftDown( GW_U32 nPos );
+
+	GW_GeodesicMesh& Mesh_;
+	const GW_Float* pWeights_;
+
+	/** the samples, and the number of each sample vertex, -1 for the others */
+	T_GeodesicVertexVector Samples_;
+	std::vector<GW_I32> SampleNumber_;
+
+	/** vertices reached by the last marching */
+	T_GeodesicVertexVector UpdatedVertex_;
+
+	struct T_Entry
+	{
+		GW_Float rDistance_;
+		GW_GeodesicVertex* pVert_;
+	};
+	std::vector<T_Entry> Heap_;
+	std::vector<GW_I32> HeapPosition_;
+
+};
+
+} // End namespace GW
+
+
+#endif // _GW_FURTHESTPOINTSAMPLER_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
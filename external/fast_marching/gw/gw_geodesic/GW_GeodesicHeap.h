@@ -0,0 +1,202 @@
+/*------------------------------------------------------------------------------*/
+/**
+ *  \file   GW_GeodesicHeap.h
+ *  \brief  Definition of class \c GW_GeodesicHeap
+ *  \date   10-15-2026
+ */
+/*------------------------------------------------------------------------------*/
+
+#ifndef _GW_GEODESICHEAP_H_
+#define _GW_GEODESICHEAP_H_
+
+#include "../gw_core/GW_Config.h"
+#include "GW_GeodesicVertex.h"
+
+namespace GW {
+
+/*------------------------------------------------------------------------------*/
+/**
+ *  \class  GW_GeodesicHeap
+ *  \brief  Indexed min-heap of the active vertices of a fast marching.
+ *  \date   10-15-2026
+ *
+ *  A 4-ary heap ordered by distance. The distance is copied in the heap entry
+ *  so that the sift operations do not touch the vertices, and each vertex
+ *  stores its position in the heap so that its distance can be decreased in
+ *  O(log n) instead of rebuilding the whole heap.
+ */
+/*------------------------------------------------------------------------------*/
+
+class GW_GeodesicHeap
+{
+
+public:
+
+	GW_GeodesicHeap()
+	{
+		/* NOTHING */
+	}
+
+	/** number of vertices in the heap */
+	GW_U32 Size()
+	{
+		return (GW_U32) Heap_.size();
+	}
+
+	GW_Bool IsEmpty()
+	{
+		return Heap_.empty();
+	}
+
+	void Reserve( GW_U32 nSize )
+	{
+		Heap_.reserve( nSize );
+	}
+
+	/** remove all the vertices */
+	void Clear()
+	{
+		for( IT_EntryVector it=Heap_.begin(); it!=Heap_.end(); ++it )
+			it->pVert_->SetHeapPosition( -1 );
+		Heap_.clear();
+	}
+
+	GW_Bool IsInHeap( GW_GeodesicVertex& Vert )
+	{
+		GW_I32 nPos = Vert.GetHeapPosition();
+		return nPos>=0 && nPos<(GW_I32) Heap_.size() && Heap_[nPos].pVert_==&Vert;
+	}
+
+	/** vertex with the smallest distance */
+	GW_GeodesicVertex* Top()
+	{
+		GW_ASSERT( !Heap_.empty() );
+		return Heap_.front().pVert_;
+	}
+
+	/** add a vertex, or update its distance if it is already in the heap */
+	void Push( GW_GeodesicVertex& Vert, GW_Float rDistance )
+	{
+		if( this->IsInHeap(Vert) )
+		{
+			this->Update( Vert, rDistance );
+			return;
+		}
+		T_Entry Entry = { rDistance, &Vert };
+		Heap_.push_back( Entry );
+		this->SiftUp( (GW_U32) Heap_.size()-1 );
+	}
+
+	/** remove and return the vertex with the smallest distance */
+	GW_GeodesicVertex* Pop()
+	{
+		GW_ASSERT( !Heap_.empty() );
+		GW_GeodesicVertex* pVert = Heap_.front().pVert_;
+		pVert->SetHeapPosition( -1 );
+		T_Entry Last = Heap_.back();
+		Heap_.pop_back();
+		if( !Heap_.empty() )
+		{
+			Heap_[0] = Last;
+			this->SiftDown( 0 );
+		}
+		return pVert;
+	}
+
+	/** change the distance of a vertex already in the heap */
+	void Update( GW_GeodesicVertex& Vert, GW_Float rDistance )
+	{
+		GW_ASSERT( this->IsInHeap(Vert) );
+		GW_U32 nPos = (GW_U32) Vert.GetHeapPosition();
+		GW_Float rOld = Heap_[nPos].rDistance_;
+		Heap_[nPos].rDistance_ = rDistance;
+		if( rDistance<rOld )
+			this->SiftUp( nPos );
+		else
+			this->SiftDown( nPos );
+	}
+
+	/** reload the distances from the vertices and restore the heap order */
+	void Rebuild()
+	{
+		for( IT_EntryVector it=Heap_.begin(); it!=Heap_.end(); ++it )
+			it->rDistance_ = it->pVert_->GetDistance();
+		if( Heap_.size()<2 )
+		{
+			if( !Heap_.empty() )
+				Heap_[0].pVert_->SetHeapPosition( 0 );
+			return;
+		}
+		for( GW_I32 i=(GW_I32) (Heap_.size()-2)/kArity_; i>=0; --i )
+			this->SiftDown( (GW_U32) i );
+		for( GW_U32 i=0; i<Heap_.size(); ++i )
+			Heap_[i].pVert_->SetHeapPosition( i );
+	}
+
+private:
+
+	enum { kArity_ = 4 };
+
+	struct T_Entry
+	{
+		GW_Float rDistance_;
+		GW_GeodesicVertex* pVert_;
+	};
+	typedef std::vector<T_Entry> T_EntryVector;
+	typedef T_EntryVector::iterator IT_EntryVector;
+
+	void SiftUp( GW_U32 nPos )
+	{
+		T_Entry Entry = Heap_[nPos];
+		while( nPos>0 )
+		{
+			GW_U32 nParent = (nPos-1)/kArity_;
+			if( Heap_[nParent].rDistance_<=Entry.rDistance_ )
+				break;
+			Heap_[nPos] = Heap_[nParent];
+			Heap_[nPos].pVert_->SetHeapPosition( nPos );
+			nPos = nParent;
+		}
+		Heap_[nPos] = Entry;
+		Entry.pVert_->SetHeapPosition( nPos );
+	}
+
+	void SiftDown( GW_U32 nPos )
+	{
+		GW_U32 nSize = (GW_U32) Heap_.size();
+		T_Entry Entry = Heap_[nPos];
+		while( GW_True )
+		{
+			GW_U32 nChild = kArity_*nPos+1;
+			if( nChild>=nSize )
+				break;
+			/* smallest child */
+			GW_U32 nEnd = GW_MIN( nChild+kArity_, nSize );
+			GW_U32 nMin = nChild;
+			for( GW_U32 i=nChild+1; i<nEnd; ++i )
+				if( Heap_[i].rDistance_<Heap_[nMin].rDistance_ )
+					nMin = i;
+			if( Entry.rDistance_<=Heap_[nMin].rDistance_ )
+				break;
+			Heap_[nPos] = Heap_[nMin];
+			Heap_[nPos].pVert_->SetHeapPosition( nPos );
+			nPos = nMin;
+		}
+		Heap_[nPos] = Entry;
+		Entry.pVert_->SetHeapPosition( nPos );
+	}
+
+	T_EntryVector Heap_;
+
+};
+
+
+} // End namespace GW
+
+
+#endif // _GW_GEODESICHEAP_H_
+
+
+///////////////////////////////////////////////////////////////////////////////
+//                               END OF FILE                                 //
+///////////////////////////////////////////////////////////////////////////////
@@ -40,7 +40,7 @@ void GW_GeodesicMesh::ResetGeodesicMesh()
 		GW_GeodesicVertex* pVert = (GW_GeodesicVertex*) *it;
 		pVert->ResetGeodesicVertex();
 	}
-	ActiveVertex_.clear();
+	ActiveVertex_.Clear();
 }
 
 /*------------------------------------------------------------------------------*/
@@ -78,8 +78,6 @@ void GW_GeodesicMesh::PerformFastMarching( GW_GeodesicVertex* pStartVertex )
 	
 	this->SetUpFastMarching( pStartVertex );
 
-	// first time : set up the heap
-	std::make_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
 	/* main loop */
 	while( !this->PerformFastMarchingOneStep() )
 	{ }
@@ -102,7 +100,8 @@ void GW_GeodesicMesh::SetUpFastMarching( GW_GeodesicVertex* pStartVertex )
 	if( pStartVertex!=NULL )
 		this->AddStartVertex( *pStartVertex );
 
-	std::make_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
+	// set up the heap, the distance of the start vertices may have been changed
+	ActiveVertex_.Rebuild();
 
 	bIsMarchingBegin_ = GW_True;
 	bIsMarchingEnd_ = GW_False;
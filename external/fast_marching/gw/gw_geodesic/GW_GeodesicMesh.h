@@ -18,6 +18,7 @@
 #include "../gw_core/GW_VertexIterator.h"
 #include "GW_GeodesicVertex.h"
 #include "GW_GeodesicFace.h"
+#include "GW_GeodesicHeap.h"
 
 namespace GW {
 
@@ -86,6 +87,25 @@ public:
 	void RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc );
 	//@}
 
+    //-------------------------------------------------------------------------
+    /** \name Callback management with user data, the pointer given to
+	    RegisterCallbackData is passed to each call. */
+    //-------------------------------------------------------------------------
+    //@{
+	void RegisterCallbackData( void* pData );
+	void* GetCallbackData();
+	typedef GW_Float (*T_WeightCallbackFunctionData)( GW_GeodesicVertex& Vert, void* pData );
+	void RegisterWeightCallbackFunctionData( T_WeightCallbackFunctionData pFunc );
+	typedef GW_Bool (*T_FastMarchingCallbackFunctionData)( GW_GeodesicVertex& Vert, void* pData );
+	void RegisterForceStopCallbackFunctionData( T_FastMarchingCallbackFunctionData pFunc );
+	typedef void (*T_NewDeadVertexCallbackFunctionData)( GW_GeodesicVertex& Vert, void* pData );
+	void RegisterNewDeadVertexCallbackFunctionData( T_NewDeadVertexCallbackFunctionData pFunc );
+	typedef GW_Bool (*T_VertexInsersionCallbackFunctionData)( GW_GeodesicVertex& Vert, GW_Float rNewDist, void* pData );
+	void RegisterVertexInsersionCallbackFunctionData( T_VertexInsersionCallbackFunctionData pFunc );
+	typedef GW_Float (*T_HeuristicToGoalCallbackFunctionData)( GW_GeodesicVertex& Vert, void* pData );
+	void RegisterHeuristicToGoalCallbackFunctionData( T_HeuristicToGoalCallbackFunctionData pFunc );
+	//@}
+
 	virtual GW_Vertex* GetRandomVertex( GW_Bool bForceFar = GW_True );
 
 	static GW_Float BasicWeightCallback(GW_GeodesicVertex& Vert);
@@ -94,8 +114,8 @@ public:
 protected:
 
 	/** should be filled with the starting point of the marching before
-	    calling PerformFastMarching */
-	T_GeodesicVertexVector ActiveVertex_;
+	    calling PerformFastMarching. Heap of the alive vertices. */
+	GW_GeodesicHeap ActiveVertex_;
 
 	/** a function that specify the metric on the mesh */
 	T_WeightCallbackFunction WeightCallback_;
@@ -107,6 +127,15 @@ protected:
 	T_VertexInsersionCallbackFunction VertexInsersionCallback_;
 	/** a function called to give an heuristic for the remaining distance */
 	T_HeuristicToGoalCallbackFunction HeuristicToGoalCallbackFunction_;
+
+	/** the same callbacks taking a user data pointer, used instead of the ones above when not NULL */
+	T_WeightCallbackFunctionData WeightCallbackData_;
+	T_FastMarchingCallbackFunctionData ForceStopCallbackData_;
+	T_NewDeadVertexCallbackFunctionData NewDeadVertexCallbackData_;
+	T_VertexInsersionCallbackFunctionData VertexInsersionCallbackData_;
+	T_HeuristicToGoalCallbackFunctionData HeuristicToGoalCallbackFunctionData_;
+	/** user data given to the callbacks */
+	void* pCallbackData_;
 	
 	/** just to controle interactive mode */
 	GW_Bool bIsMarchingBegin_;
@@ -115,6 +144,11 @@ protected:
 
 private:
 
+	GW_Float GetWeight( GW_GeodesicVertex& Vert );
+	GW_Bool GetForceStop( GW_GeodesicVertex& Vert );
+	void NotifyNewDeadVertex( GW_GeodesicVertex& Vert );
+	GW_Bool GetVertexInsersion( GW_GeodesicVertex& Vert, GW_Float rNewDist );
+
 	GW_Float ComputeVertexDistance( GW_GeodesicFace& CurrentFace, GW_GeodesicVertex& CurrentVertex, 
 									GW_GeodesicVertex& Vert1, GW_GeodesicVertex& Vert2, GW_GeodesicVertex& CurrentFront );
 
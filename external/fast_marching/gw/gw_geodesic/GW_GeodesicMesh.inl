@@ -28,6 +28,12 @@ GW_GeodesicMesh::GW_GeodesicMesh()
 	ForceStopCallback_			( NULL ),
 	NewDeadVertexCallback_		( NULL ),
 	HeuristicToGoalCallbackFunction_	( NULL ),
+	WeightCallbackData_			( NULL ),
+	ForceStopCallbackData_		( NULL ),
+	NewDeadVertexCallbackData_	( NULL ),
+	VertexInsersionCallbackData_	( NULL ),
+	HeuristicToGoalCallbackFunctionData_	( NULL ),
+	pCallbackData_				( NULL ),
 	bIsMarchingBegin_			( GW_False ),
 	bIsMarchingEnd_				( GW_False )
 {
@@ -99,7 +105,7 @@ void GW_GeodesicMesh::AddStartVertex( GW_GeodesicVertex& StartVert )
 	StartVert.SetFront( &StartVert );
 	StartVert.SetDistance(0);
 	StartVert.SetState( GW_GeodesicVertex::kAlive );
-	ActiveVertex_.push_back( &StartVert );
+	ActiveVertex_.Push( StartVert, 0 );
 }
 
 /*------------------------------------------------------------------------------*/
@@ -134,6 +140,7 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterForceStopCallbackFunction( T_FastMarchingCallbackFunction pFunc )
 {
 	ForceStopCallback_ = pFunc;
+	ForceStopCallbackData_ = NULL;
 }
 
 
@@ -152,6 +159,7 @@ void GW_GeodesicMesh::RegisterWeightCallbackFunction( T_WeightCallbackFunction p
 {
 	GW_ASSERT( pFunc!=NULL );
 	WeightCallback_ = pFunc;
+	WeightCallbackData_ = NULL;
 }
 
 
@@ -169,6 +177,7 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoalCallbackFunction pFunc )
 {
 	HeuristicToGoalCallbackFunction_ = pFunc;
+	HeuristicToGoalCallbackFunctionData_ = NULL;
 }
 
 
@@ -185,24 +194,20 @@ void GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunction( T_HeuristicToGoal
 GW_INLINE
 GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 {
-	if( ActiveVertex_.empty() )
+	if( ActiveVertex_.IsEmpty() )
 		return GW_True;
 
 	GW_ASSERT( bIsMarchingBegin_ );
-//	std::make_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
 	
-	GW_GeodesicVertex* pCurVert = ActiveVertex_.front();
+	GW_GeodesicVertex* pCurVert = ActiveVertex_.Pop();
 	GW_ASSERT( pCurVert!=NULL );
-	std::pop_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
-	ActiveVertex_.pop_back();
 	pCurVert->SetState( GW_GeodesicVertex::kDead );
 
-	if( NewDeadVertexCallback_!=NULL )
-		NewDeadVertexCallback_( *pCurVert );
+	this->NotifyNewDeadVertex( *pCurVert );
 
 #if 0	// just for debug
-	for( IT_GeodesicVertexVector it = ActiveVertex_.begin(); it!=ActiveVertex_.end(); ++it )
-		GW_ASSERT( pCurVert->GetDistance()<=(*it)->GetDistance() );
+	if( !ActiveVertex_.IsEmpty() )
+		GW_ASSERT( pCurVert->GetDistance()<=ActiveVertex_.Top()->GetDistance() );
 #endif
 
 	for( GW_VertexIterator VertIt = pCurVert->BeginVertexIterator(); VertIt!=pCurVert->EndVertexIterator(); ++VertIt )
@@ -239,13 +244,11 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 			switch( pNewVert->GetState() ) {
 			case GW_GeodesicVertex::kFar:
 				/* ask to the callback if we should update this vertex and add it to the path */
-				if( VertexInsersionCallback_==NULL ||
-					VertexInsersionCallback_( *pNewVert,rNewDistance ) )
+				if( this->GetVertexInsersion( *pNewVert,rNewDistance ) )
 				{
 					pNewVert->SetDistance( rNewDistance );
 					/* add the vertex to the heap */
-					ActiveVertex_.push_back( pNewVert );
-					std::push_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
+					ActiveVertex_.Push( *pNewVert, rNewDistance );
 					/* this one can be added to the heap */
 					pNewVert->SetState( GW_GeodesicVertex::kAlive );
 					pNewVert->SetFront( pCurVert->GetFront() );
@@ -260,8 +263,8 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 						pNewVert->GetFrontOverlapInfo().RecordOverlap( *pNewVert->GetFront(), pNewVert->GetDistance() );
 					pNewVert->SetDistance( rNewDistance );
 					pNewVert->SetFront( pCurVert->GetFront() );
-					// hum, check if we can correct this (avoid recomputing the whole heap).
-					std::make_heap( ActiveVertex_.begin(), ActiveVertex_.end(), GW_GeodesicVertex::CompareVertex );
+					/* decrease its key, the vertex is moved up in the heap */
+					ActiveVertex_.Update( *pNewVert, rNewDistance );
 				}
 				else
 				{
@@ -282,10 +285,10 @@ GW_Bool GW_GeodesicMesh::PerformFastMarchingOneStep()
 	}
 
 	/* have we finished ? */
-	bIsMarchingEnd_ = ActiveVertex_.empty();
+	bIsMarchingEnd_ = ActiveVertex_.IsEmpty();
 	/* the user can force ending of the algorithm */
-	if( ForceStopCallback_!=NULL && bIsMarchingEnd_==GW_False )
-		bIsMarchingEnd_ = ForceStopCallback_(*pCurVert);
+	if( bIsMarchingEnd_==GW_False )
+		bIsMarchingEnd_ = this->GetForceStop(*pCurVert);
 
 	return bIsMarchingEnd_;
 }
@@ -307,7 +310,7 @@ GW_INLINE
 GW_Float GW_GeodesicMesh::ComputeVertexDistance( GW_GeodesicFace& CurrentFace, GW_GeodesicVertex& CurrentVertex, 
 												 GW_GeodesicVertex& Vert1, GW_GeodesicVertex& Vert2, GW_GeodesicVertex& CurrentFront )
 {	
-	GW_Float F = this->WeightCallback_( CurrentVertex );
+	GW_Float F = this->GetWeight( CurrentVertex );
 
 	if( Vert1.GetState()!=GW_GeodesicVertex::kFar ||
 		Vert2.GetState()!=GW_GeodesicVertex::kFar )
@@ -669,6 +672,7 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterVertexInsersionCallbackFunction( T_VertexInsersionCallbackFunction pFunc )
 {
 	VertexInsersionCallback_ = pFunc;
+	VertexInsersionCallbackData_ = NULL;
 }
 
 /*------------------------------------------------------------------------------*/
@@ -685,6 +689,126 @@ GW_INLINE
 void GW_GeodesicMesh::RegisterNewDeadVertexCallbackFunction( T_NewDeadVertexCallbackFunction pFunc )
 {
 	NewDeadVertexCallback_ = pFunc;
+	NewDeadVertexCallbackData_ = NULL;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::RegisterCallbackData
+/**
+ *  \param  pData [void*] User data.
+ *  \date   10-15-2026
+ * 
+ *  Set the pointer passed to the callbacks registered with a user data
+ *  argument. Keeping the state of a propagation there instead of in global
+ *  variables allows several meshes to be marched at the same time.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterCallbackData( void* pData )
+{
+	pCallbackData_ = pData;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::GetCallbackData
+/**
+ *  \return [void*] User data given to the callbacks.
+ *  \date   10-15-2026
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void* GW_GeodesicMesh::GetCallbackData()
+{
+	return pCallbackData_;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::Register*CallbackFunctionData
+/**
+ *  \param  pFunc The function, called with the user data.
+ *  \date   10-15-2026
+ * 
+ *  Same as the versions without user data, which they replace.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+void GW_GeodesicMesh::RegisterWeightCallbackFunctionData( T_WeightCallbackFunctionData pFunc )
+{
+	/* NULL goes back to the callback without user data */
+	WeightCallbackData_ = pFunc;
+}
+
+GW_INLINE
+void GW_GeodesicMesh::RegisterForceStopCallbackFunctionData( T_FastMarchingCallbackFunctionData pFunc )
+{
+	ForceStopCallbackData_ = pFunc;
+	ForceStopCallback_ = NULL;
+}
+
+GW_INLINE
+void GW_GeodesicMesh::RegisterNewDeadVertexCallbackFunctionData( T_NewDeadVertexCallbackFunctionData pFunc )
+{
+	NewDeadVertexCallbackData_ = pFunc;
+	NewDeadVertexCallback_ = NULL;
+}
+
+GW_INLINE
+void GW_GeodesicMesh::RegisterVertexInsersionCallbackFunctionData( T_VertexInsersionCallbackFunctionData pFunc )
+{
+	VertexInsersionCallbackData_ = pFunc;
+	VertexInsersionCallback_ = NULL;
+}
+
+GW_INLINE
+void GW_GeodesicMesh::RegisterHeuristicToGoalCallbackFunctionData( T_HeuristicToGoalCallbackFunctionData pFunc )
+{
+	HeuristicToGoalCallbackFunctionData_ = pFunc;
+	HeuristicToGoalCallbackFunction_ = NULL;
+}
+
+/*------------------------------------------------------------------------------*/
+// Name : GW_GeodesicMesh::GetWeight
+/**
+ *  \date   10-15-2026
+ * 
+ *  Dispatch to the registered callbacks, with or without user data.
+ */
+/*------------------------------------------------------------------------------*/
+GW_INLINE
+GW_Float GW_GeodesicMesh::GetWeight( GW_GeodesicVertex& Vert )
+{
+	if( WeightCallbackData_!=NULL )
+		return WeightCallbackData_( Vert, pCallbackData_ );
+	return WeightCallback_( Vert );
+}
+
+GW_INLINE
+GW_Bool GW_GeodesicMesh::GetForceStop( GW_GeodesicVertex& Vert )
+{
+	if( ForceStopCallbackData_!=NULL )
+		return ForceStopCallbackData_( Vert, pCallbackData_ );
+	if( ForceStopCallback_!=NULL )
+		return ForceStopCallback_( Vert );
+	return GW_False;
+}
+
+GW_INLINE
+void GW_GeodesicMesh::NotifyNewDeadVertex( GW_GeodesicVertex& Vert )
+{
+	if( NewDeadVertexCallbackData_!=NULL )
+		NewDeadVertexCallbackData_( Vert, pCallbackData_ );
+	else if( NewDeadVertexCallback_!=NULL )
+		NewDeadVertexCallback_( Vert );
+}
+
+GW_INLINE
+GW_Bool GW_GeodesicMesh::GetVertexInsersion( GW_GeodesicVertex& Vert, GW_Float rNewDist )
+{
+	if( VertexInsersionCallbackData_!=NULL )
+		return VertexInsersionCallbackData_( Vert, rNewDist, pCallbackData_ );
+	if( VertexInsersionCallback_!=NULL )
+		return VertexInsersionCallback_( Vert, rNewDist );
+	return GW_True;
 }
 
 /*------------------------------------------------------------------------------*/
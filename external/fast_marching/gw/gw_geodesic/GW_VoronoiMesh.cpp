@@ -219,6 +219,11 @@ GW_Face* GW_VoronoiMesh::FindMaxFace( GW_GeodesicVertex& Vert )
  *  \date   4-14-2003
  * 
  *  Add a given number of furthest points.
+ *
+ *  After the first point, the points are added by a GW_FurthestPointSampler.
+ *  As in AddFurthestPoint, each new point only marches over the vertices it
+ *  gets closer to, but the vertex states are not reset over the whole mesh
+ *  and the furthest vertex is kept in a heap instead of being searched for.
  */
 /*------------------------------------------------------------------------------*/
 GW_U32 GW_VoronoiMesh::AddFurthestPointsIterate( T_GeodesicVertexList& VertList,GW_GeodesicMesh& Mesh, GW_U32 nNbrIterations, GW_Bool bUseRandomStartVertex, GW_Bool bUseProgressBar )
@@ -227,11 +232,26 @@ GW_U32 GW_VoronoiMesh::AddFurthestPointsIterate( T_GeodesicVertexList& VertList,
 	GW_ProgressBar pb;
 	if( bUseProgressBar )
 		pb.Begin();
-	for( GW_U32 i=0; i<nNbrIterations; ++i )
+	GW_U32 i = 0;
+	if( VertList.empty() && nNbrIterations>0 )
 	{
 		nNbrPoints += GW_VoronoiMesh::AddFurthestPoint( VertList, Mesh, bUseRandomStartVertex );
-		if( bUseProgressBar )
-			pb.Update(((GW_Float) i+1)/((GW_Float) nNbrIterations));
+		i++;
+	}
+	if( i<nNbrIterations )
+	{
+		GW_FurthestPointSampler Sampler( Mesh );
+		Sampler.SetStartVertices( VertList );
+		for( ; i<nNbrIterations; ++i )
+		{
+			GW_GeodesicVertex* pNewVert = Sampler.AddFurthestVertex();
+			if( pNewVert==NULL )
+				break;
+			VertList.push_back( pNewVert );
+			nNbrPoints++;
+			if( bUseProgressBar )
+				pb.Update(((GW_Float) i+1)/((GW_Float) nNbrIterations));
+		}
 	}
 	if( bUseProgressBar )
 	{
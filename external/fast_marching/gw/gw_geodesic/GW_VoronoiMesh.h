@@ -15,6 +15,7 @@
 #include "GW_GeodesicMesh.h"
 #include "GW_GeodesicPath.h"
 #include "GW_VoronoiVertex.h"
+#include "GW_FurthestPointSampler.h"
 #include "../gw_core/GW_ProgressBar.h"
 
 namespace GW {
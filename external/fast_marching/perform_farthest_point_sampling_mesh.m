@@ -0,0 +1,51 @@
+function [points,labels,D,T,N] = perform_farthest_point_sampling_mesh(vertex, faces, nbr_points, options)
+
+% perform_farthest_point_sampling_mesh - geodesic farthest point sampling of a 3D mesh.
+%
+%   [points,labels,D,T,N] = perform_farthest_point_sampling_mesh(vertex, faces, nbr_points, options)
+%
+%   vertex, faces: a 3D mesh
+%   nbr_points: total number of points, start points included, each new
+%       one the farthest from all the previous ones. All the start points
+%       are returned even if there are more than nbr_points.
+%
+%   points are the indices of the sampled vertices, start points included.
+%   labels(i) is the index in points of the point closest to vertex i,
+%       i.e. the geodesic Voronoi cell of the vertex, 0 if not reached.
+%   D is the geodesic distance to the points.
+%   T(k) is the time in seconds spent until points(k) was added, and N(k)
+%       the number of vertices its propagation reached.
+%
+%   As before, each new point only propagates over the vertices it gets
+%   closer to. The distances are now kept between two points and the
+%   farthest vertex is kept in a heap, so adding a point no longer resets
+%   the vertex states of the whole mesh and scans it for the farthest
+%   vertex.
+%
+%   Optional:
+%   - options.start_points : first points. Without them the first point
+%     is the vertex farthest from vertex 1.
+%   - options.W : weight of each vertex, as in perform_fast_marching_mesh.
+
+options.null = 0;
+
+start_points = getoptions(options, 'start_points', []);
+W            = getoptions(options, 'W', []);
+
+if exist('farthest_point_sampling_mesh')==0
+    error('You have to run compile_mex before.');
+end
+
+if size(vertex,1)>size(vertex,2)
+    vertex = vertex';
+end
+if size(faces,1)>size(faces,2)
+    faces = faces';
+end
+
+[points,labels,D,T,N] = farthest_point_sampling_mesh(vertex, faces-1, nbr_points, start_points(:)-1, W(:));
+points = points+1;
+labels = labels+1;
+
+% replace C 'Inf' value (1e9) by Matlab Inf value.
+D(D>1e8) = Inf;
@@ -0,0 +1,82 @@
+function [D,Q,S,engine] = perform_fast_marching_mesh_batch(vertex, faces, start_points, options)
+
+% perform_fast_marching_mesh_batch - Fast Marching from many seed sets on a 3D mesh.
+%
+%   [D,Q,S,engine] = perform_fast_marching_mesh_batch(vertex, faces, start_points, options)
+%
+%   vertex, faces: a 3D mesh
+%   start_points is either a vector, each entry being a seed on its own,
+%       or a cell array of index vectors, one seed set per cell.
+%
+%   D(:,k) is the distance function to the k-th seed set.
+%   Q(:,k) is the index of the closest seed of the k-th set, 0 for far
+%       points.
+%   S(:,k) is the final state of the points, as in perform_fast_marching_mesh.
+%
+%   The seed sets are processed in parallel on a mesh built once by
+%   geodesic_engine. When the engine is requested as an output it is kept
+%   alive and can be given back in options.engine to run more queries
+%   without building the mesh again, vertex and faces are then ignored;
+%   free it with geodesic_engine('delete', engine).
+%
+%   Optional, shared by all the seed sets:
+%   - options.W, options.end_points, options.nb_iter_max,
+%     options.constraint_map, options.dmax as in perform_fast_marching_mesh.
+%   - options.nthreads : number of worker threads, 0 for the number of
+%     cores. Each thread holds its own copy of the mesh.
+%   - options.engine : an engine returned by a previous call.
+
+options.null = 0;
+
+end_points  = getoptions(options, 'end_points', []);
+nb_iter_max = getoptions(options, 'nb_iter_max', Inf);
+W           = getoptions(options, 'W', []);
+L           = getoptions(options, 'constraint_map', []);
+dmax        = getoptions(options, 'dmax', 1e9);
+nthreads    = getoptions(options, 'nthreads', 0);
+engine      = getoptions(options, 'engine', []);
+
+I = find(L==-Inf); L(I)=-1e9;
+I = find(L==Inf); L(I)=1e9;
+
+if exist('geodesic_engine')==0
+    error('You have to run compile_mex before.');
+end
+
+owned = isempty(engine);
+if owned
+    if size(vertex,1)>size(vertex,2)
+        vertex = vertex';
+    end
+    if size(faces,1)>size(faces,2)
+        faces = faces';
+    end
+    engine = geodesic_engine('create', vertex, faces-1, nthreads);
+end
+
+nverts = max(size(vertex));
+if ~isempty(W)
+    nb_iter_max = min(nb_iter_max, 1.2*length(W));
+elseif owned
+    nb_iter_max = min(nb_iter_max, 1.2*nverts);
+end
+if isinf(nb_iter_max)
+    nb_iter_max = [];
+end
+
+if iscell(start_points)
+    start_points = cellfun(@(s)s(:)-1, start_points, 'UniformOutput', false);
+else
+    start_points = start_points(:)-1;
+end
+
+[D,Q,S] = geodesic_engine('query', engine, start_points, W(:), end_points(:)-1, nb_iter_max, L(:), dmax);
+Q = Q+1;
+
+if owned && nargout<4
+    geodesic_engine('delete', engine);
+    engine = [];
+end
+
+% replace C 'Inf' value (1e9) by Matlab Inf value.
+D(D>1e8) = Inf;
@@ -31,10 +31,7 @@ using std::cout;
 using std::endl;
 
 #include "mex.h"
-#include "gw/gw_core/GW_Config.h"
-#include "gw/gw_core/GW_MathsWrapper.h"
-#include "gw/gw_geodesic/GW_GeodesicMesh.h"
-using namespace GW;
+#include "front_propagation.h"
 
 
 inline void display_message(const char* mess, int v)
@@ -45,72 +42,24 @@ inline void display_message(const char* mess, int v)
 }
 
 
-
-double* vertex = NULL;
-int nverts = -1; 
-double* faces = NULL;
-int nfaces = -1; 
-double* start_points = NULL;
-int nstart = -1;
-double* end_points = NULL;
-int nend = -1;
-double* H = NULL;	// heuristic
-double* L = NULL;	// bound on current distance
-double* Ww = NULL;	// weight
-int niter_max = -1;
-double dmax = 1e9;
-double* values = NULL;
-// outputs 
-double* D = NULL;	// distance
-double* S = NULL;	// state
-double* Q = NULL;	// nearest neighbor
-
-#define faces_(k,i) faces[k+3*i]
-#define vertex_(k,i) vertex[k+3*i]
-
-
-GW_Float WeightCallback(GW_GeodesicVertex& Vert)
-{
-	GW_U32 i = Vert.GetID();
-	return Ww[i];
-}
-
-GW_Bool StopMarchingCallback( GW_GeodesicVertex& Vert )
-{
-	// check if the end point has been reached
-	GW_U32 i = Vert.GetID();
-//	display_message("ind %d",i );
-//	display_message("dist %f",Vert.GetDistance() );
-	if( Vert.GetDistance()>dmax )
-		return true;
-	for( int k=0; k<nend; ++k )
-		if( end_points[k]==i )
-			return true;
-	return false;
-}
-int nbr_iter = 0;
-GW_Bool InsersionCallback( GW_GeodesicVertex& Vert, GW_Float rNewDist )
-{
-	// check if the distance of the new point is less than the given distance
-	GW_U32 i = Vert.GetID();
-	bool doinsersion = nbr_iter<=niter_max;
-	if( L!=NULL )
-		doinsersion = doinsersion && (rNewDist<L[i]);
-	nbr_iter++;
-	return doinsersion;
-}
-GW_Float HeuristicCallback( GW_GeodesicVertex& Vert )
-{
-	// return the heuristic distance
-	GW_U32 i = Vert.GetID();
-	return H[i];
-}
-
-
 void mexFunction(	int nlhs, mxArray *plhs[], 
 				 int nrhs, const mxArray*prhs[] ) 
 { 
-	nbr_iter = 0;
+	double* vertex = NULL;
+	int nverts = -1; 
+	double* faces = NULL;
+	int nfaces = -1; 
+	double* start_points = NULL;
+	int nstart = -1;
+	double* end_points = NULL;
+	int nend = -1;
+	double* values = NULL;
+	// outputs 
+	double* D = NULL;	// distance
+	double* S = NULL;	// state
+	double* Q = NULL;	// nearest neighbor
+	T_FrontPropagation fp;
+
 	/* retrive arguments */
 	if( nrhs<6 ) 
 		mexErrMsgTxt("6 or 7 input arguments are required."); 
@@ -128,7 +77,7 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	if( mxGetM(prhs[1])!=3 )
 		mexErrMsgTxt("face must be of size 3 x nfaces."); 
 	// arg3 : W
-	Ww = mxGetPr(prhs[2]);
+	fp.Ww = mxGetPr(prhs[2]);
 	int m = mxGetM(prhs[2]);
 	if( m!=nverts )
 		mexErrMsgTxt("W must be of same size as vertex."); 
@@ -139,33 +88,27 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 	end_points = mxGetPr(prhs[4]);
 	nend = mxGetM(prhs[4]);
 	// arg6 : niter_max
-	niter_max = (int) *mxGetPr(prhs[5]);
+	fp.niter_max = (int) *mxGetPr(prhs[5]);
 	// arg7 : H
 	if( nrhs>=7 )
 	{
-		H = mxGetPr(prhs[6]);
+		fp.H = mxGetPr(prhs[6]);
 		int m =mxGetM(prhs[6]);
 		if( m>0 && m!=nverts )
 			mexErrMsgTxt("H must be of size nverts."); 
 		if( m==0 )
-			H = NULL;
-	}
-	else
-	{
-		H = NULL;
+			fp.H = NULL;
 	}
 	// arg8 : L
 	if( nrhs>=8 )
 	{
-		L = mxGetPr(prhs[7]);
+		fp.L = mxGetPr(prhs[7]);
 		int m =mxGetM(prhs[7]);
 		if( m>0 && mxGetM(prhs[7])!=nverts )
 			mexErrMsgTxt("L must be of size nverts."); 
 		if( m==0 )
-			L = NULL;
+			fp.L = NULL;
 	}
-	else
-		L = NULL;
 		
 	// argument 9: value list
 	if( nrhs>=9 )
@@ -176,13 +119,16 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 		if( values!=NULL && (mxGetM(prhs[8])!=nstart || mxGetN(prhs[8])!=1) )
 			mexErrMsgTxt("values must be of size nb_start_points x 1."); 
 	}
-	else
-		values = NULL;
 	// argument 10: dmax
-	if( nrhs>=9 )
-		dmax = *mxGetPr(prhs[9]);
-	else
-		dmax = 1e9;
+	if( nrhs>=10 )
+		fp.dmax = *mxGetPr(prhs[9]);
+	// end points are tested at each step
+	std::vector<char> is_end;
+	if( nend>0 )
+	{
+		mark_end_points( is_end, nverts, end_points, nend );
+		fp.is_end = &is_end[0];
+	}
 
 
 	// first ouput : distance
@@ -197,66 +143,11 @@ void mexFunction(	int nlhs, mxArray *plhs[],
 
 	// create the mesh
 	GW_GeodesicMesh Mesh;
-	Mesh.SetNbrVertex(nverts);
-	for( int i=0; i<nverts; ++i )
-	{
-		GW_GeodesicVertex& vert = (GW_GeodesicVertex&) Mesh.CreateNewVertex();
-		vert.SetPosition( GW_Vector3D(vertex_(0,i),vertex_(1,i),vertex_(2,i)) );
-		Mesh.SetVertex(i, &vert);
-	}
-	Mesh.SetNbrFace(nfaces);
-	for( int i=0; i<nfaces; ++i )
-	{
-		GW_GeodesicFace& face = (GW_GeodesicFace&) Mesh.CreateNewFace();
-		GW_Vertex* v1 = Mesh.GetVertex((int) faces_(0,i)); GW_ASSERT( v1!=NULL );
-		GW_Vertex* v2 = Mesh.GetVertex((int) faces_(1,i)); GW_ASSERT( v2!=NULL );
-		GW_Vertex* v3 = Mesh.GetVertex((int) faces_(2,i)); GW_ASSERT( v3!=NULL );
-		face.SetVertex( *v1,*v2,*v3 );
-		Mesh.SetFace(i, &face);
-	}
-	Mesh.BuildConnectivity();
+	build_geodesic_mesh( Mesh, vertex, nverts, faces, nfaces );
 
-	// set up fast marching	
-	Mesh.ResetGeodesicMesh();
-	for( int i=0; i<nstart; ++i )
-	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
-		GW_ASSERT( v!=NULL );
-		Mesh.AddStartVertex( *v );
-	}
-	Mesh.SetUpFastMarching();
-	Mesh.RegisterWeightCallbackFunction( WeightCallback );
-	Mesh.RegisterForceStopCallbackFunction( StopMarchingCallback );
-	Mesh.RegisterVertexInsersionCallbackFunction( InsersionCallback );
-	if( H!=NULL )
-		Mesh.RegisterHeuristicToGoalCallbackFunction( HeuristicCallback );
-	// initialize the distance of the starting points
-	if( values!=NULL )
-	for( int i=0; i<nstart; ++i )
-	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) start_points[i]);
-		GW_ASSERT( v!=NULL );
-		v->SetDistance( values[i] );
-	}
-	
 	// perform fast marching
 //	display_message("itermax=%d", niter_max);
-	Mesh.PerformFastMarching();
-
-	// output result
-	for( int i=0; i<nverts; ++i )
-	{
-		GW_GeodesicVertex* v = (GW_GeodesicVertex*) Mesh.GetVertex((GW_U32) i);
-		GW_ASSERT( v!=NULL );
-		D[i] = v->GetDistance();
-		S[i] = v->GetState();
-		GW_GeodesicVertex* v1 = v->GetFront();
-		if( v1==NULL )
-			Q[i] = -1;
-		else
-			Q[i] = v1->GetID();
-	}
-	
+	perform_front_propagation( Mesh, fp, start_points, nstart, values, D, S, Q );
 
 	return;
 }